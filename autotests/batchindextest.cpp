@@ -0,0 +1,87 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "batchindex.h"
+
+#include <QDateTime>
+#include <QTimeZone>
+#include <QtTest/qtest.h>
+
+using namespace Qt::Literals;
+
+static QDateTime dt(int day, int hour)
+{
+    return QDateTime({2026, 5, day}, {hour, 0}, QTimeZone::UTC);
+}
+
+class BatchIndexTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testOrder()
+    {
+        BatchIndex index;
+        index.append(u"c"_s, dt(3, 10), dt(3, 12));
+        index.append(u"a"_s, dt(1, 10), dt(1, 12));
+        index.append(u"long"_s, dt(1, 10), dt(2, 12));
+        index.append(u"unbound"_s, {}, {});
+        index.sort();
+        QCOMPARE(index.batchIds(), (std::vector<QString>{u"unbound"_s, u"long"_s, u"a"_s, u"c"_s}));
+
+        index.insert(u"b"_s, dt(2, 10), {});
+        QCOMPARE(index.batchIds(), (std::vector<QString>{u"unbound"_s, u"long"_s, u"a"_s, u"b"_s, u"c"_s}));
+        QCOMPARE(index.indexOf(u"b"_s), 3);
+        QCOMPARE(index.indexOf(u"x"_s), -1);
+        QCOMPARE(index.previous(u"b"_s), u"a"_s);
+        QCOMPARE(index.next(u"b"_s), u"c"_s);
+        QCOMPARE(index.previous(u"unbound"_s), QString());
+        QCOMPARE(index.next(u"c"_s), QString());
+
+        QCOMPARE(index.lowerBound(dt(1, 10)), 1);
+        QCOMPARE(index.lowerBound(dt(1, 11)), 3);
+        QCOMPARE(index.lowerBound(dt(5, 0)), 5);
+
+        // move forward and backward
+        index.update(u"a"_s, dt(4, 10), dt(4, 12));
+        QCOMPARE(index.batchIds(), (std::vector<QString>{u"unbound"_s, u"long"_s, u"b"_s, u"c"_s, u"a"_s}));
+        index.update(u"c"_s, dt(1, 8), dt(1, 9));
+        QCOMPARE(index.batchIds(), (std::vector<QString>{u"unbound"_s, u"c"_s, u"long"_s, u"b"_s, u"a"_s}));
+        index.update(u"b"_s, dt(2, 11), {});
+        QCOMPARE(index.indexOf(u"b"_s), 3);
+
+        index.rename(u"long"_s, u"0"_s);
+        QVERIFY(!index.contains(u"long"_s));
+        QCOMPARE(index.indexOf(u"0"_s), 2);
+
+        index.remove(u"c"_s);
+        QCOMPARE(index.batchIds(), (std::vector<QString>{u"unbound"_s, u"0"_s, u"b"_s, u"a"_s}));
+        QCOMPARE(index.size(), 4);
+
+        index.clear();
+        QCOMPARE(index.size(), 0);
+        QVERIFY(!index.contains(u"a"_s));
+    }
+
+    void testOverlapping()
+    {
+        BatchIndex index;
+        index.insert(u"hotel"_s, dt(1, 15), dt(8, 10));
+        index.insert(u"flight"_s, dt(1, 10), dt(1, 12));
+        index.insert(u"event"_s, dt(4, 18), {});
+        index.insert(u"train"_s, dt(8, 12), dt(8, 14));
+        index.insert(u"unbound"_s, {}, {});
+
+        QCOMPARE(index.overlapping(dt(4, 0), dt(5, 0)), (std::vector<QString>{u"hotel"_s, u"event"_s}));
+        QCOMPARE(index.overlapping(dt(1, 11), dt(1, 16)), (std::vector<QString>{u"flight"_s, u"hotel"_s}));
+        QCOMPARE(index.overlapping(dt(8, 10), dt(9, 0)), (std::vector<QString>{u"hotel"_s, u"train"_s}));
+        QVERIFY(index.overlapping(dt(10, 0), dt(11, 0)).empty());
+        QVERIFY(index.overlapping({}, dt(11, 0)).empty());
+        QCOMPARE(index.overlapping(dt(8, 10), {}), (std::vector<QString>{u"hotel"_s, u"train"_s}));
+    }
+};
+
+QTEST_GUILESS_MAIN(BatchIndexTest)
+
+#include "batchindextest.moc"
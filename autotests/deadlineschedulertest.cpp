@@ -0,0 +1,139 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "deadlinescheduler.h"
+
+#include <QDateTime>
+#include <QtTest/qtest.h>
+
+#include <memory>
+
+using namespace Qt::Literals;
+using namespace std::chrono_literals;
+
+class DeadlineSchedulerTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSchedule()
+    {
+        DeadlineScheduler scheduler;
+        QObject early;
+        QObject late;
+        QObject far;
+
+        QStringList called;
+        const auto now = QDateTime::currentDateTime();
+        scheduler.schedule(&late, now.addMSecs(200), [&called]() {
+            called.push_back(u"late"_s);
+        });
+        scheduler.schedule(&early, now.addMSecs(50), [&called]() {
+            called.push_back(u"early"_s);
+        });
+        scheduler.schedule(&far, now.addSecs(3600), [&called]() {
+            called.push_back(u"far"_s);
+        });
+        QCOMPARE(scheduler.size(), 3);
+
+        QTRY_COMPARE(called.size(), 2);
+        QCOMPARE(called, QStringList({u"early"_s, u"late"_s}));
+        QVERIFY(QDateTime::currentDateTime() >= now.addMSecs(200));
+        QVERIFY(!scheduler.isScheduled(&early));
+        QVERIFY(!scheduler.isScheduled(&late));
+        QVERIFY(scheduler.isScheduled(&far));
+        QCOMPARE(scheduler.size(), 1);
+    }
+
+    void testReschedule()
+    {
+        DeadlineScheduler scheduler;
+        QObject obj;
+        int count = 0;
+        const auto now = QDateTime::currentDateTime();
+
+        // rescheduling replaces the previous deadline
+        scheduler.schedule(&obj, now.addMSecs(50), [&count]() {
+            count += 1;
+        });
+        scheduler.schedule(&obj, now.addMSecs(100), [&count]() {
+            count += 10;
+        });
+        QCOMPARE(scheduler.size(), 1);
+        QTRY_COMPARE(count, 10);
+        QTest::qWait(100);
+        QCOMPARE(count, 10);
+
+        // callbacks can reschedule themselves
+        count = 0;
+        std::function<void()> repeat = [&]() {
+            if (++count < 3) {
+                scheduler.schedule(&obj, QDateTime::currentDateTime().addMSecs(20), std::function<void()>(repeat));
+            }
+        };
+        scheduler.schedule(&obj, QDateTime::currentDateTime().addMSecs(20), std::function<void()>(repeat));
+        QTRY_COMPARE(count, 3);
+        QVERIFY(!scheduler.isScheduled(&obj));
+
+        // cancelling
+        count = 0;
+        scheduler.schedule(&obj, QDateTime::currentDateTime().addMSecs(50), [&count]() {
+            ++count;
+        });
+        scheduler.cancel(&obj);
+        QVERIFY(!scheduler.isScheduled(&obj));
+        QTest::qWait(150);
+        QCOMPARE(count, 0);
+    }
+
+    void testSubscriberDestroyed()
+    {
+        DeadlineScheduler scheduler;
+        auto obj = std::make_unique<QObject>();
+        bool called = false;
+        scheduler.schedule(obj.get(), QDateTime::currentDateTime().addMSecs(50), [&called]() {
+            called = true;
+        });
+        QCOMPARE(scheduler.size(), 1);
+        obj.reset();
+        QCOMPARE(scheduler.size(), 0);
+        QTest::qWait(150);
+        QVERIFY(!called);
+    }
+
+    void testSlack()
+    {
+        DeadlineScheduler scheduler;
+        QObject obj1;
+        QObject obj2;
+        QList<qint64> calledAt;
+
+        // both deadlines are rounded up to the same multiple of the slack, and handled together
+        const auto slack = 500ms;
+        auto base = QDateTime::currentMSecsSinceEpoch();
+        base = base - (base % slack.count()) + 2 * slack.count();
+        scheduler.schedule(
+            &obj1,
+            QDateTime::fromMSecsSinceEpoch(base + 10),
+            [&calledAt]() {
+                calledAt.push_back(QDateTime::currentMSecsSinceEpoch());
+            },
+            slack);
+        scheduler.schedule(
+            &obj2,
+            QDateTime::fromMSecsSinceEpoch(base + 400),
+            [&calledAt]() {
+                calledAt.push_back(QDateTime::currentMSecsSinceEpoch());
+            },
+            slack);
+
+        QTRY_COMPARE(calledAt.size(), 2);
+        QVERIFY(calledAt[0] >= base + slack.count());
+        QVERIFY(calledAt[1] >= base + slack.count());
+    }
+};
+
+QTEST_GUILESS_MAIN(DeadlineSchedulerTest)
+
+#include "deadlineschedulertest.moc"
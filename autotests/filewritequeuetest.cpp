@@ -0,0 +1,77 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "filewritequeue.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTimeZone>
+#include <QtTest/qtest.h>
+
+using namespace Qt::Literals;
+
+static QByteArray readFile(const QString &fileName)
+{
+    QFile f(fileName);
+    if (!f.open(QFile::ReadOnly)) {
+        return {};
+    }
+    return f.readAll();
+}
+
+class FileWriteQueueTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testWrite()
+    {
+        QTemporaryDir dir;
+        const auto fileName = dir.filePath(u"sub/dir/file.json"_s);
+
+        FileWriteQueue::write(fileName, "v1"_ba);
+        FileWriteQueue::write(fileName, "v2"_ba);
+        QVERIFY(!QFile::exists(fileName));
+        FileWriteQueue::flush();
+        QCOMPARE(readFile(fileName), "v2"_ba);
+
+        // write behind
+        FileWriteQueue::write(fileName, "v3"_ba);
+        QCOMPARE(readFile(fileName), "v2"_ba);
+        QTRY_COMPARE(readFile(fileName), "v3"_ba);
+
+        // modification time
+        const QDateTime mtime({2026, 5, 1}, {12, 0}, QTimeZone::UTC);
+        FileWriteQueue::write(fileName, "v4"_ba, mtime);
+        FileWriteQueue::flush();
+        QCOMPARE(readFile(fileName), "v4"_ba);
+        QCOMPARE(QFileInfo(fileName).lastModified().toUTC(), mtime);
+    }
+
+    void testRemove()
+    {
+        QTemporaryDir dir;
+        const auto fileName = dir.filePath(u"file.json"_s);
+        FileWriteQueue::write(fileName, "v1"_ba);
+        FileWriteQueue::flush();
+        QVERIFY(QFile::exists(fileName));
+
+        // removal overrides a pending write, and vice versa
+        FileWriteQueue::write(fileName, "v2"_ba);
+        FileWriteQueue::remove(fileName);
+        FileWriteQueue::flush();
+        QVERIFY(!QFile::exists(fileName));
+
+        FileWriteQueue::remove(fileName);
+        FileWriteQueue::write(fileName, "v3"_ba);
+        FileWriteQueue::flush();
+        QCOMPARE(readFile(fileName), "v3"_ba);
+    }
+};
+
+QTEST_GUILESS_MAIN(FileWriteQueueTest)
+
+#include "filewritequeuetest.moc"
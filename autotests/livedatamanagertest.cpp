@@ -13,12 +13,19 @@
 #include "livedatamanager.h"
 #include "reservationmanager.h"
 #include "timelinedelegatecontroller.h"
+#include "tripquerydispatcher.h"
 
 #include <KItinerary/Reservation>
 #include <KItinerary/TrainTrip>
 
+#include <KPublicTransport/JourneySection>
 #include <KPublicTransport/Manager>
+#include <KPublicTransport/Path>
+#include <KPublicTransport/TripRequest>
 
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QSignalSpy>
@@ -45,6 +52,7 @@ private Q_SLOTS:
     {
         LiveData::clearStorage();
         QCOMPARE(LiveData::listAll(), std::vector<QString>());
+        const auto initialStoreSize = QFileInfo(LiveData::storePath()).size();
 
         {
             LiveData ld;
@@ -60,6 +68,14 @@ private Q_SLOTS:
             auto ld = LiveData::load(s("testId"));
             QCOMPARE(ld.journey().scheduledDepartureTime(), QDateTime({2017, 9, 10}, {11, 0}));
             QCOMPARE(ld.journeyTimestamp, QDateTime({2017, 1, 1}, {0, 0}));
+
+            // unchanged trips are not written again, only the meta data record is
+            const auto storeSize = QFileInfo(LiveData::storePath()).size();
+            ld.journeyTimestamp = {{2017, 1, 2}, {0, 0}};
+            ld.store(s("testId"));
+            QCOMPARE_LT(QFileInfo(LiveData::storePath()).size() - storeSize, storeSize - initialStoreSize);
+            QCOMPARE(LiveData::load(s("testId")).journeyTimestamp, QDateTime({2017, 1, 2}, {0, 0}));
+
             ld.trip = {};
             ld.store(s("testId"));
         }
@@ -67,6 +83,90 @@ private Q_SLOTS:
         QCOMPARE(LiveData::listAll(), std::vector<QString>());
     }
 
+    void testPathStorage()
+    {
+        LiveData::clearStorage();
+
+        KPublicTransport::Location from;
+        from.setName(s("Randa"));
+        from.setCoordinate(46.0998, 7.7815);
+        KPublicTransport::Location to;
+        to.setName(s("Visp"));
+        to.setCoordinate(46.2940, 7.8814);
+        KPublicTransport::PathSection pathSec;
+        pathSec.setPath(QPolygonF({{7.7815, 46.0998}, {7.8, 46.2}, {7.8814, 46.2940}}));
+        KPublicTransport::Path path;
+        path.setSections({pathSec});
+
+        LiveData ld;
+        ld.trip.setMode(KPublicTransport::JourneySection::PublicTransport);
+        ld.trip.setScheduledDepartureTime({{2017, 9, 10}, {11, 0}});
+        ld.trip.setFrom(from);
+        ld.trip.setTo(to);
+        ld.trip.setPath(path);
+        ld.store(s("batch1"));
+        QVERIFY(ld.trip.path().isEmpty());
+        QVERIFY(ld.hasPath());
+        QCOMPARE(LiveData::listAll(), std::vector<QString>({s("batch1")}));
+
+        // path isn't loaded with the trip, only on demand
+        auto ld1 = LiveData::load(s("batch1"));
+        QVERIFY(ld1.trip.path().isEmpty());
+        QVERIFY(ld1.hasPath());
+        QCOMPARE(ld1.loadPath().sections().size(), std::size_t(1));
+        QCOMPARE(ld1.tripWithPath().path().sections()[0].path().size(), qsizetype(3));
+
+        // updates without a path retain the stored one, and batches on the same trip share it
+        ld1.trip.setPath({});
+        ld1.store(s("batch1"));
+        ld1.store(s("batch2"));
+        QVERIFY(LiveData::load(s("batch2")).hasPath());
+        QCOMPARE(LiveData::load(s("batch2")).loadPath().sections().size(), std::size_t(1));
+
+        // that also holds if the trip identity changes slightly
+        ld1.trip.setScheduledDepartureTime({{2017, 9, 10}, {11, 1}});
+        ld1.store(s("batch1"));
+        QVERIFY(LiveData::load(s("batch1")).hasPath());
+        QVERIFY(LiveData::load(s("batch2")).hasPath());
+
+        // path is removed with the last trip referencing it
+        LiveData::remove(s("batch1"));
+        QVERIFY(LiveData::load(s("batch2")).hasPath());
+        LiveData::remove(s("batch2"));
+        QVERIFY(!ld1.hasPath());
+        QCOMPARE(LiveData::listAll(), std::vector<QString>());
+    }
+
+    void testLegacyImport()
+    {
+        LiveData::clearStorage();
+        QDir().mkpath(LiveData::basePath());
+        {
+            KPublicTransport::JourneySection jny;
+            jny.setMode(KPublicTransport::JourneySection::PublicTransport);
+            jny.setScheduledDepartureTime({{2017, 9, 10}, {11, 0}});
+            QFile f(LiveData::basePath() + "legacyId.json"_L1);
+            QVERIFY(f.open(QFile::WriteOnly));
+            f.write(QJsonDocument(KPublicTransport::JourneySection::toJson(jny)).toJson());
+        }
+
+        // legacy data is only picked up by the migration
+        QCOMPARE(LiveData::listAll(), std::vector<QString>());
+        QVERIFY(LiveData::load(s("legacyId")).isEmpty());
+
+        QCOMPARE(LiveData::importLegacyFiles(), 1);
+        QVERIFY(!QFile::exists(LiveData::basePath() + "legacyId.json"_L1));
+        QDir(LiveData::basePath()).removeRecursively();
+        QCOMPARE(LiveData::listAll(), std::vector<QString>({s("legacyId")}));
+        const auto ld = LiveData::load(s("legacyId"));
+        QCOMPARE(ld.journey().scheduledDepartureTime(), QDateTime({2017, 9, 10}, {11, 0}));
+        QVERIFY(ld.journeyTimestamp.isValid());
+        QCOMPARE(ld.departureIndex, 0);
+
+        LiveData::clearStorage();
+        QCOMPARE(LiveData::listAll(), std::vector<QString>());
+    }
+
     void testLiveData()
     {
         ReservationManager resMgr;
@@ -228,6 +328,17 @@ private Q_SLOTS:
         ldm.tripQueryFailed(trainLeg2);
         QCOMPARE(ldm.departure(trainLeg2).stopPoint().isEmpty(), true);
         QCOMPARE(ldm.nextPollTimeForReservation(trainLeg2), std::chrono::minutes(15));
+
+        // poll schedule, also re-evaluated when the poll interval changes
+        QVERIFY(ldm.m_reservations.contains(trainLeg2));
+        QVERIFY(!ldm.m_reservations.contains(flight));
+        QCOMPARE(ldm.nextPollCheckTime(trainLeg2), QDateTime({2017, 9, 10}, {12, 15}, QTimeZone("Europe/Zurich")));
+        ldm.m_unitTestTime = QDateTime({2017, 9, 10}, {13, 0}, QTimeZone("Europe/Zurich"));
+        ldm.tripQueryFailed(trainLeg2);
+        // the 5 minute poll interval starts one hour before departure
+        QCOMPARE(ldm.nextPollCheckTime(trainLeg2), QDateTime({2017, 9, 10}, {13, 8}, QTimeZone("Europe/Zurich")));
+        QCOMPARE(ldm.m_reservations.value(trainLeg2), QDateTime({2017, 9, 10}, {13, 8}, QTimeZone("Europe/Zurich")).toMSecsSinceEpoch());
+        QCOMPARE(ldm.nextPollTime(), std::chrono::seconds(0)); // trainLeg1 is still due
     }
 
     void testPkPassUpdate()
@@ -283,6 +394,55 @@ private Q_SLOTS:
         QCOMPARE(ldm.nextPollTime(), std::chrono::seconds(0));
     }
 
+    void testTripQueryDispatcher()
+    {
+        MockNetworkAccessManager nam;
+        KPublicTransport::Manager ptMgr;
+        ptMgr.setNetworkAccessManager(&nam);
+        TripQueryDispatcher dispatcher(&ptMgr);
+        dispatcher.setMaximumConcurrentQueries(2);
+        QSignalSpy finishedSpy(&dispatcher, &TripQueryDispatcher::tripQueryFinished);
+        QSignalSpy failedSpy(&dispatcher, &TripQueryDispatcher::tripQueryFailed);
+
+        const auto makeRequest = [](int hour) {
+            KPublicTransport::Location from;
+            from.setName(u"Visp"_s);
+            from.setCoordinate(46.29405, 7.88145);
+            KPublicTransport::Location to;
+            to.setName(u"Randa"_s);
+            to.setCoordinate(46.09925, 7.78075);
+            KPublicTransport::JourneySection jny;
+            jny.setMode(KPublicTransport::JourneySection::PublicTransport);
+            jny.setFrom(from);
+            jny.setTo(to);
+            jny.setScheduledDepartureTime(QDateTime({2017, 9, 10}, {hour, 8}, QTimeZone("Europe/Zurich")));
+            KPublicTransport::TripRequest req(jny);
+            req.setBackendIds({u"ch_opentransportdata"_s});
+            return req;
+        };
+
+        // identical requests are coalesced, the rest is queued beyond the concurrency limit
+        dispatcher.query(u"batch1"_s, makeRequest(14));
+        dispatcher.query(u"batch2"_s, makeRequest(14));
+        dispatcher.query(u"batch3"_s, makeRequest(15));
+        dispatcher.query(u"batch4"_s, makeRequest(16));
+        dispatcher.query(u"batch5"_s, makeRequest(17));
+        dispatcher.query(u"batch5"_s, makeRequest(17));
+        QCOMPARE(dispatcher.runningQueries(), 2);
+        QCOMPARE(dispatcher.queuedQueries(), 2);
+
+        // all of them fail, but every batch gets its result exactly once
+        QTRY_COMPARE(failedSpy.size() + finishedSpy.size(), 5);
+        QCOMPARE(dispatcher.runningQueries(), 0);
+        QCOMPARE(dispatcher.queuedQueries(), 0);
+        QStringList batchIds;
+        for (const auto &args : failedSpy) {
+            batchIds.push_back(args.at(0).toString());
+        }
+        batchIds.sort();
+        QCOMPARE(batchIds, QStringList({u"batch1"_s, u"batch2"_s, u"batch3"_s, u"batch4"_s, u"batch5"_s}));
+    }
+
 private:
     MockNetworkAccessManager m_nam;
 };
@@ -0,0 +1,136 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "recordstore.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest/qtest.h>
+
+using namespace Qt::Literals;
+
+class RecordStoreTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testReadWrite()
+    {
+        QTemporaryDir dir;
+        const auto fileName = dir.filePath(u"store.log"_s);
+        {
+            RecordStore store(fileName);
+            QVERIFY(store.isEmpty());
+            QVERIFY(store.read(u"a"_s).isNull());
+
+            store.write(u"a"_s, "value a"_ba);
+            store.write(u"b"_s, "value b"_ba);
+            store.write(u"a"_s, "new value a"_ba);
+            QVERIFY(!store.isEmpty());
+            QVERIFY(store.contains(u"a"_s));
+            QCOMPARE(store.read(u"a"_s), "new value a"_ba);
+            QCOMPARE(store.read(u"b"_s), "value b"_ba);
+
+            auto records = store.readAll();
+            QCOMPARE(records.size(), 2);
+            QCOMPARE(records[0].first, u"b"_s);
+            QCOMPARE(records[0].second, "value b"_ba);
+            QCOMPARE(records[1].first, u"a"_s);
+            QCOMPARE(records[1].second, "new value a"_ba);
+
+            store.remove(u"b"_s);
+            QVERIFY(!store.contains(u"b"_s));
+            QVERIFY(store.read(u"b"_s).isNull());
+            QCOMPARE(store.keys().size(), 1);
+        }
+
+        // reopen
+        {
+            RecordStore store(fileName);
+            QCOMPARE(store.keys(), std::vector<QString>{u"a"_s});
+            QCOMPARE(store.read(u"a"_s), "new value a"_ba);
+
+            store.clear();
+            QVERIFY(store.isEmpty());
+        }
+        {
+            RecordStore store(fileName);
+            QVERIFY(store.isEmpty());
+        }
+    }
+
+    void testCompact()
+    {
+        QTemporaryDir dir;
+        const auto fileName = dir.filePath(u"store.log"_s);
+        RecordStore store(fileName);
+        for (int i = 0; i < 100; ++i) {
+            store.write(u"a"_s, QByteArray(1000, 'a'));
+            store.write(QString::number(i), QByteArray::number(i));
+        }
+        store.remove(u"42"_s);
+        const auto size = QFile(fileName).size();
+
+        store.compact();
+        QVERIFY(QFile(fileName).size() < size);
+        QCOMPARE(store.keys().size(), 100);
+        QCOMPARE(store.read(u"a"_s), QByteArray(1000, 'a'));
+        QCOMPARE(store.read(u"23"_s), "23"_ba);
+        QVERIFY(!store.contains(u"42"_s));
+
+        store.write(u"b"_s, "b"_ba);
+        RecordStore store2(fileName);
+        QCOMPARE(store2.keys().size(), 101);
+        QCOMPARE(store2.read(u"b"_s), "b"_ba);
+    }
+
+    void testTruncatedFile()
+    {
+        QTemporaryDir dir;
+        const auto fileName = dir.filePath(u"store.log"_s);
+        {
+            RecordStore store(fileName);
+            store.write(u"a"_s, "value a"_ba);
+            store.write(u"b"_s, "value b"_ba);
+        }
+
+        // simulate an incomplete write
+        QFile f(fileName);
+        QVERIFY(f.open(QFile::ReadWrite));
+        QVERIFY(f.resize(f.size() - 3));
+        f.close();
+
+        {
+            RecordStore store(fileName);
+            QCOMPARE(store.keys(), std::vector<QString>{u"a"_s});
+            QCOMPARE(store.read(u"a"_s), "value a"_ba);
+            store.write(u"c"_s, "value c"_ba);
+        }
+        {
+            RecordStore store(fileName);
+            QCOMPARE(store.keys().size(), 2);
+            QCOMPARE(store.read(u"c"_s), "value c"_ba);
+        }
+    }
+
+    void testInvalidFile()
+    {
+        QTemporaryDir dir;
+        const auto fileName = dir.filePath(u"store.log"_s);
+        QFile f(fileName);
+        QVERIFY(f.open(QFile::WriteOnly));
+        f.write("not a record store");
+        f.close();
+
+        RecordStore store(fileName);
+        QVERIFY(store.isEmpty());
+        QVERIFY(QFile::exists(fileName + ".invalid"_L1));
+        store.write(u"a"_s, "value a"_ba);
+        QCOMPARE(store.read(u"a"_s), "value a"_ba);
+    }
+};
+
+QTEST_GUILESS_MAIN(RecordStoreTest)
+
+#include "recordstoretest.moc"
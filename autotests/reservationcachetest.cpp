@@ -0,0 +1,81 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "reservationcache.h"
+
+#include <QtTest/qtest.h>
+
+using namespace Qt::Literals;
+
+class ReservationCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testLru()
+    {
+        ReservationCache cache(300);
+        QVERIFY(cache.value(u"a"_s).isNull());
+        QCOMPARE(cache.statistics().misses, 1);
+
+        cache.insert(u"a"_s, 1, 100, ReservationCache::NormalPriority);
+        cache.insert(u"b"_s, 2, 100, ReservationCache::NormalPriority);
+        cache.insert(u"c"_s, 3, 100, ReservationCache::NormalPriority);
+        QCOMPARE(cache.statistics().count, 3);
+        QCOMPARE(cache.statistics().cost, 300);
+        QCOMPARE(cache.value(u"a"_s).toInt(), 1);
+        QCOMPARE(cache.statistics().hits, 1);
+
+        // b is the least recently used one now
+        cache.insert(u"d"_s, 4, 100, ReservationCache::NormalPriority);
+        QVERIFY(!cache.contains(u"b"_s));
+        QVERIFY(cache.contains(u"a"_s));
+        QVERIFY(cache.contains(u"c"_s));
+        QVERIFY(cache.contains(u"d"_s));
+        QCOMPARE(cache.statistics().evictions, 1);
+
+        // replacing an entry updates its cost
+        cache.insert(u"a"_s, 5, 50, ReservationCache::NormalPriority);
+        QCOMPARE(cache.statistics().cost, 250);
+        QCOMPARE(cache.value(u"a"_s).toInt(), 5);
+
+        cache.remove(u"c"_s);
+        QCOMPARE(cache.statistics().count, 2);
+        QCOMPARE(cache.statistics().cost, 150);
+
+        cache.clear();
+        QCOMPARE(cache.statistics().count, 0);
+        QCOMPARE(cache.statistics().cost, 0);
+    }
+
+    void testPriority()
+    {
+        ReservationCache cache(300);
+        cache.insert(u"past"_s, 1, 100, ReservationCache::LowPriority);
+        cache.insert(u"a"_s, 2, 100, ReservationCache::NormalPriority);
+        cache.insert(u"b"_s, 3, 100, ReservationCache::NormalPriority);
+        QVERIFY(!cache.value(u"past"_s).isNull());
+
+        // low priority entries go first, even if more recently used
+        cache.insert(u"c"_s, 4, 100, ReservationCache::NormalPriority);
+        QVERIFY(!cache.contains(u"past"_s));
+        QVERIFY(cache.contains(u"a"_s));
+
+        // entries exceeding the budget on their own are kept until replaced
+        cache.insert(u"huge"_s, 5, 1000, ReservationCache::LowPriority);
+        QCOMPARE(cache.statistics().count, 1);
+        QVERIFY(cache.contains(u"huge"_s));
+
+        cache.insert(u"d"_s, 6, 10, ReservationCache::NormalPriority);
+        QVERIFY(!cache.contains(u"huge"_s));
+        QCOMPARE(cache.statistics().cost, 10);
+
+        cache.setBudget(5);
+        QCOMPARE(cache.statistics().count, 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(ReservationCacheTest)
+
+#include "reservationcachetest.moc"
@@ -12,15 +12,21 @@
 #include "reservationmanager.h"
 
 #include <KItinerary/Flight>
+#include <KItinerary/JsonLdDocument>
 #include <KItinerary/Place>
 #include <KItinerary/Reservation>
 #include <KItinerary/Visit>
 
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSettings>
 #include <QSignalSpy>
 #include <QStandardPaths>
+#include <QTemporaryDir>
 #include <QtTest/qtest.h>
 
 using namespace KItinerary;
+using namespace Qt::Literals;
 
 class ReservationManagerTest : public QObject
 {
@@ -160,6 +166,58 @@ private Q_SLOTS:
         const auto l2 = mgr2.reservationsForBatch(batchId);
         QCOMPARE(l2.size(), 2);
         QVERIFY((l2.at(0) == l.at(0) && l2.at(1) == l.at(1)) || (l2.at(0) == l.at(1) && l2.at(1) == l.at(0)));
+
+        // asynchronous loading
+        QSignalSpy loadedSpy(&mgr2, &ReservationManager::batchesLoaded);
+        mgr2.loadBatchesAsync({batchId});
+        QVERIFY(loadedSpy.wait());
+        QCOMPARE(loadedSpy.at(0).at(0).toStringList(), QStringList({batchId}));
+        QCOMPARE(mgr2.cacheStatistics().count, 2);
+        QVERIFY(!mgr2.reservation(resId).isNull());
+        QCOMPARE(mgr2.cacheStatistics().hits, 1);
+        QCOMPARE(mgr2.cacheStatistics().misses, 0);
+    }
+
+    void testReservationStorage()
+    {
+        ReservationManager mgr;
+        Test::clearAll(&mgr);
+        auto ctrl = Test::makeAppController();
+        ctrl->setReservationManager(&mgr);
+
+        ImportController importer;
+        importer.setReservationManager(&mgr);
+        importer.importFromUrl(QUrl::fromLocalFile(QLatin1StringView(SOURCE_DIR "/data/4U8465-v1.json")));
+        ctrl->commitImport(&importer);
+        QCOMPARE(mgr.batches().size(), 1);
+        const auto resId = mgr.batches()[0];
+        const auto res = JsonLdDocument::toJson(mgr.reservation(resId));
+
+        // background post-processing upgrade
+        QSettings().remove("ReservationStore/PostprocessorVersion"_L1);
+        mgr.upgradeStoredReservations();
+        QTRY_VERIFY(QSettings().contains("ReservationStore/PostprocessorVersion"_L1));
+        QVERIFY(ReservationManager::isPostProcessed(resId));
+        {
+            ReservationManager mgr2;
+            QCOMPARE(JsonLdDocument::toJson(mgr2.reservation(resId)), res);
+        }
+
+        // updates derived from post-processed data, such as live data, retain the stamp
+        auto updatedRes = mgr.reservation(resId).value<FlightReservation>();
+        updatedRes.setReservationNumber(u"XXX007"_s);
+        mgr.updateBatch({{resId, QVariant::fromValue(updatedRes)}}, true);
+        QVERIFY(ReservationManager::isPostProcessed(resId));
+        mgr.updateBatch({{resId, QVariant::fromValue(updatedRes)}}, false);
+        QVERIFY(!ReservationManager::isPostProcessed(resId));
+
+        // one file per reservation import/export
+        QTemporaryDir dir;
+        QCOMPARE(ReservationManager::exportReservationFiles(dir.path()), 1);
+        QVERIFY(QFile::exists(dir.filePath(resId + ".jsonld"_L1)));
+        Test::clearAll(&mgr);
+        QCOMPARE(ReservationManager::importReservationFiles(dir.path()), 1);
+        mgr.removeReservation(resId);
     }
 
     void testBatchOperations()
@@ -173,6 +231,7 @@ private Q_SLOTS:
         QSignalSpy batchContentSpy(&mgr, &ReservationManager::batchContentChanged);
         QSignalSpy batchRenameSpy(&mgr, &ReservationManager::batchRenamed);
         QSignalSpy batchRemovedSpy(&mgr, &ReservationManager::batchRemoved);
+        QSignalSpy batchesChangedSpy(&mgr, &ReservationManager::batchesChanged);
 
         auto ctrl = Test::makeAppController();
         ctrl->setReservationManager(&mgr);
@@ -181,7 +240,9 @@ private Q_SLOTS:
         importer.importFromUrl(QUrl::fromLocalFile(QLatin1StringView(SOURCE_DIR "/data/google-multi-passenger-flight.json")));
         ctrl->commitImport(&importer);
         QCOMPARE(batchAddSpy.size(), 2);
-        QCOMPARE(batchChangeSpy.size(), 2);
+        QCOMPARE(batchChangeSpy.size(), 0); // coalesced with batchAdded by the import bulk update
+        QCOMPARE(batchesChangedSpy.size(), 1);
+        QCOMPARE(batchesChangedSpy.at(0).at(0).toStringList().size(), 2);
         QCOMPARE(batchRenameSpy.size(), 0);
         QCOMPARE(batchRemovedSpy.size(), 0);
 
@@ -331,6 +392,69 @@ private Q_SLOTS:
         QCOMPARE(mgr.batchForReservation(batchId), QString());
     }
 
+    void testBulkUpdate()
+    {
+        ReservationManager mgr;
+        Test::clearAll(&mgr);
+
+        QSignalSpy addSpy(&mgr, &ReservationManager::reservationAdded);
+        QSignalSpy batchAddSpy(&mgr, &ReservationManager::batchAdded);
+        QSignalSpy batchChangeSpy(&mgr, &ReservationManager::batchChanged);
+        QSignalSpy batchesChangedSpy(&mgr, &ReservationManager::batchesChanged);
+
+        const auto resData = JsonLdDocument::fromJson(QJsonDocument::fromJson(Test::readFile(QLatin1StringView(SOURCE_DIR "/data/google-multi-passenger-flight.json"))).array());
+        QCOMPARE(resData.size(), 4);
+        {
+            ReservationBulkUpdate bulkUpdate(&mgr);
+            QVERIFY(mgr.isBulkUpdateInProgress());
+            const auto resIds = mgr.addReservationsWithPostProcessing(resData);
+            QCOMPARE(resIds.size(), 4);
+            QCOMPARE(addSpy.size(), 4);
+            QCOMPARE(mgr.batches().size(), 2);
+            for (const auto &resId : resIds) {
+                QVERIFY(!mgr.reservation(resId).isNull());
+            }
+
+            // nothing notified or written yet
+            QCOMPARE(batchAddSpy.size(), 0);
+            QCOMPARE(batchesChangedSpy.size(), 0);
+            ReservationManager mgr2;
+            QCOMPARE(mgr2.batches().size(), 0);
+        }
+
+        QVERIFY(!mgr.isBulkUpdateInProgress());
+        QCOMPARE(batchAddSpy.size(), 2);
+        QCOMPARE(batchChangeSpy.size(), 0);
+        QCOMPARE(batchesChangedSpy.size(), 1);
+        QCOMPARE(batchesChangedSpy.at(0).at(0).toStringList(), QStringList({batchAddSpy.at(0).at(0).toString(), batchAddSpy.at(1).at(0).toString()}));
+
+        ReservationManager mgr2;
+        QCOMPARE(mgr2.batches(), mgr.batches());
+        for (const auto &batchId : mgr.batches()) {
+            QCOMPARE(mgr2.reservationsForBatch(batchId).size(), 2);
+            for (const auto &resId : mgr2.reservationsForBatch(batchId)) {
+                QCOMPARE(JsonLdDocument::toJson(mgr2.reservation(resId)), JsonLdDocument::toJson(mgr.reservation(resId)));
+            }
+        }
+
+        // changes that cancel out aren't notified at all
+        batchAddSpy.clear();
+        batchesChangedSpy.clear();
+        QSignalSpy batchRemovedSpy(&mgr, &ReservationManager::batchRemoved);
+        {
+            ReservationBulkUpdate bulkUpdate(&mgr);
+            const auto batchId = mgr.batches().at(0);
+            const auto res = mgr.reservation(batchId);
+            mgr.removeBatch(batchId);
+            QCOMPARE(mgr.batches().size(), 1);
+            const auto resIds = mgr.addReservations({res}, {batchId});
+            QCOMPARE(resIds, QList<QString>({batchId}));
+        }
+        QCOMPARE(batchAddSpy.size(), 0);
+        QCOMPARE(batchRemovedSpy.size(), 0);
+        QCOMPARE(batchesChangedSpy.size(), 1);
+    }
+
     void testCancellation()
     {
         ReservationManager mgr;
@@ -22,10 +22,12 @@
 #include "weatherforecast.h"
 #include "weatherforecastmanager.h"
 
+#include <KItinerary/Event>
 #include <KItinerary/Flight>
 #include <KItinerary/LocationUtil>
 #include <KItinerary/Place>
 #include <KItinerary/Reservation>
+#include <KItinerary/TrainTrip>
 
 #include <QAbstractItemModelTester>
 #include <QDirIterator>
@@ -45,6 +47,25 @@ void initLocale()
 
 Q_CONSTRUCTOR_FUNCTION(initLocale)
 
+// compare the result of incremental updates with a freshly populated model
+static void compareWithFreshModel(TimelineModel *model, ReservationManager *resMgr, TransferManager *transferMgr, TripGroupManager *tgMgr, const QString &tgId)
+{
+    TimelineModel fresh;
+    fresh.setHomeCountryIsoCode(QStringLiteral("DE"));
+    fresh.setCurrentDateTime(model->now());
+    fresh.setReservationManager(resMgr);
+    fresh.setTransferManager(transferMgr);
+    fresh.setTripGroupManager(tgMgr);
+    fresh.setTripGroupId(tgId);
+    Test::waitForReset(&fresh);
+
+    QCOMPARE(model->rowCount(), fresh.rowCount());
+    for (int i = 0; i < model->rowCount(); ++i) {
+        QCOMPARE(model->index(i, 0).data(TimelineModel::ElementTypeRole), fresh.index(i, 0).data(TimelineModel::ElementTypeRole));
+        QCOMPARE(model->index(i, 0).data(TimelineModel::StartDateTimeRole), fresh.index(i, 0).data(TimelineModel::StartDateTimeRole));
+    }
+}
+
 class TimelineModelTest : public QObject
 {
     Q_OBJECT
@@ -280,6 +301,214 @@ private Q_SLOTS:
         QCOMPARE(model.rowCount(), 0);
     }
 
+    void testIncrementalInformationElements()
+    {
+        ReservationManager resMgr;
+        Test::clearAll(&resMgr);
+        auto ctrl = Test::makeAppController();
+        ctrl->setReservationManager(&resMgr);
+        TransferManager::clear();
+        TransferManager transferMgr;
+        TripGroupManager groupMgr;
+        groupMgr.setReservationManager(&resMgr);
+        groupMgr.setTransferManager(&transferMgr);
+        ctrl->setTripGroupManager(&groupMgr);
+
+        ImportController importer;
+        importer.setReservationManager(&resMgr);
+        importer.importFromUrl(QUrl::fromLocalFile(QLatin1StringView(SOURCE_DIR "/../tests/randa2017.json")));
+        ctrl->commitImport(&importer);
+        QCOMPARE(groupMgr.tripGroups().size(), 1);
+        const auto tgId = groupMgr.tripGroups()[0];
+
+        TimelineModel model;
+        QAbstractItemModelTester tester(&model);
+        model.setHomeCountryIsoCode(QStringLiteral("DE"));
+        model.setCurrentDateTime({{2017, 9, 1}, {12, 0}});
+        model.setReservationManager(&resMgr);
+        model.setTransferManager(&transferMgr);
+        model.setTripGroupManager(&groupMgr);
+        model.setTripGroupId(tgId);
+        Test::waitForReset(&model);
+        QVERIFY(model.rowCount() > 0);
+        compareWithFreshModel(&model, &resMgr, &transferMgr, &groupMgr, tgId);
+        QVERIFY(!QTest::currentTestFailed());
+
+        // move a train trip
+        QString trainBatchId;
+        for (int i = 0; i < model.rowCount() && trainBatchId.isEmpty(); ++i) {
+            if (model.index(i, 0).data(TimelineModel::ElementTypeRole) == TimelineElement::TrainTrip) {
+                trainBatchId = model.index(i, 0).data(TimelineModel::BatchIdRole).toString();
+            }
+        }
+        QVERIFY(!trainBatchId.isEmpty());
+        auto res = resMgr.reservation(trainBatchId).value<KItinerary::TrainReservation>();
+        auto trip = res.reservationFor().value<KItinerary::TrainTrip>();
+        trip.setDepartureTime(trip.departureTime().addSecs(3600));
+        trip.setArrivalTime(trip.arrivalTime().addSecs(3600));
+        res.setReservationFor(trip);
+        resMgr.updateReservation(trainBatchId, res);
+        compareWithFreshModel(&model, &resMgr, &transferMgr, &groupMgr, tgId);
+        QVERIFY(!QTest::currentTestFailed());
+
+        // remove a flight
+        QString flightBatchId;
+        for (int i = 0; i < model.rowCount() && flightBatchId.isEmpty(); ++i) {
+            if (model.index(i, 0).data(TimelineModel::ElementTypeRole) == TimelineElement::Flight) {
+                flightBatchId = model.index(i, 0).data(TimelineModel::BatchIdRole).toString();
+            }
+        }
+        QVERIFY(!flightBatchId.isEmpty());
+        resMgr.removeBatch(flightBatchId);
+        compareWithFreshModel(&model, &resMgr, &transferMgr, &groupMgr, tgId);
+        QVERIFY(!QTest::currentTestFailed());
+    }
+
+    void testWindowed()
+    {
+        using namespace KItinerary;
+
+        ReservationManager resMgr;
+        Test::clearAll(&resMgr);
+        auto ctrl = Test::makeAppController();
+        ctrl->setReservationManager(&resMgr);
+        TransferManager::clear();
+        TransferManager transferMgr;
+        TripGroupManager groupMgr;
+        groupMgr.setReservationManager(&resMgr);
+        groupMgr.setTransferManager(&transferMgr);
+        ctrl->setTripGroupManager(&groupMgr);
+
+        ImportController importer;
+        importer.setReservationManager(&resMgr);
+        importer.importFromUrl(QUrl::fromLocalFile(QLatin1StringView(SOURCE_DIR "/../tests/randa2017.json")));
+        ctrl->commitImport(&importer);
+        QCOMPARE(groupMgr.tripGroups().size(), 1);
+        const auto tgId = groupMgr.tripGroups()[0];
+        groupMgr.suspend(); // we are going to create an unusually long trip below
+
+        TimelineModel model;
+        QAbstractItemModelTester tester(&model);
+        model.setHomeCountryIsoCode(QStringLiteral("DE"));
+        model.setCurrentDateTime({{2017, 9, 11}, {12, 34}});
+        model.setWindowed(true);
+        model.setReservationManager(&resMgr);
+        model.setTransferManager(&transferMgr);
+        model.setTripGroupManager(&groupMgr);
+        model.setTripGroupId(tgId);
+        Test::waitForReset(&model);
+        QVERIFY(model.rowCount() > 0);
+        QVERIFY(!model.canFetchMore({}));
+        QVERIFY(!model.canFetchEarlier());
+        compareWithFreshModel(&model, &resMgr, &transferMgr, &groupMgr, tgId);
+        QVERIFY(!QTest::currentTestFailed());
+
+        const auto makeEvent = [](const QDateTime &dt) {
+            PostalAddress addr;
+            addr.setAddressCountry(u"DE"_s);
+            addr.setAddressLocality(u"Berlin"_s);
+            Place place;
+            place.setAddress(addr);
+            Event ev;
+            ev.setName(u"Test Event"_s);
+            ev.setStartDate(dt);
+            ev.setLocation(place);
+            EventReservation res;
+            res.setReservationFor(ev);
+            return QVariant::fromValue(res);
+        };
+
+        // elements outside of the window are only added on demand
+        const auto rowCount = model.rowCount();
+        const auto laterId = resMgr.addReservation(makeEvent({{2017, 12, 1}, {19, 0}}));
+        groupMgr.addToGroup({laterId}, tgId);
+        QCOMPARE(model.rowCount(), rowCount);
+        QVERIFY(model.canFetchMore({}));
+        QVERIFY(!model.canFetchEarlier());
+        model.fetchMore({});
+        QVERIFY(!model.canFetchMore({}));
+        QVERIFY(model.rowCount() > rowCount);
+        compareWithFreshModel(&model, &resMgr, &transferMgr, &groupMgr, tgId);
+        QVERIFY(!QTest::currentTestFailed());
+
+        const auto earlierId = resMgr.addReservation(makeEvent({{2017, 6, 1}, {19, 0}}));
+        const auto fetchedRowCount = model.rowCount();
+        groupMgr.addToGroup({earlierId}, tgId);
+        QCOMPARE(model.rowCount(), fetchedRowCount);
+        QVERIFY(model.canFetchEarlier());
+        model.fetchEarlier();
+        QVERIFY(!model.canFetchEarlier());
+        QVERIFY(model.rowCount() > fetchedRowCount);
+        compareWithFreshModel(&model, &resMgr, &transferMgr, &groupMgr, tgId);
+        QVERIFY(!QTest::currentTestFailed());
+    }
+
+    void testWindowedPastTrip()
+    {
+        using namespace KItinerary;
+
+        ReservationManager resMgr;
+        Test::clearAll(&resMgr);
+        auto ctrl = Test::makeAppController();
+        ctrl->setReservationManager(&resMgr);
+        TransferManager::clear();
+        TransferManager transferMgr;
+        TripGroupManager groupMgr;
+        groupMgr.setReservationManager(&resMgr);
+        groupMgr.setTransferManager(&transferMgr);
+        ctrl->setTripGroupManager(&groupMgr);
+
+        ImportController importer;
+        importer.setReservationManager(&resMgr);
+        importer.importFromUrl(QUrl::fromLocalFile(QLatin1StringView(SOURCE_DIR "/../tests/randa2017.json")));
+        ctrl->commitImport(&importer);
+        QCOMPARE(groupMgr.tripGroups().size(), 1);
+        const auto tgId = groupMgr.tripGroups()[0];
+        groupMgr.suspend(); // extend the trip far beyond the initial window
+
+        for (int month = 3; month <= 8; ++month) {
+            PostalAddress addr;
+            addr.setAddressCountry(u"DE"_s);
+            addr.setAddressLocality(u"Berlin"_s);
+            Place place;
+            place.setAddress(addr);
+            Event ev;
+            ev.setName(u"Test Event"_s);
+            ev.setStartDate({{2017, month, 1}, {19, 0}});
+            ev.setLocation(place);
+            EventReservation res;
+            res.setReservationFor(ev);
+            groupMgr.addToGroup({resMgr.addReservation(QVariant::fromValue(res))}, tgId);
+        }
+
+        // the trip is long over, so the window is anchored at its end
+        TimelineModel model;
+        QAbstractItemModelTester tester(&model);
+        QSignalSpy windowSpy(&model, &TimelineModel::windowChanged);
+        model.setHomeCountryIsoCode(QStringLiteral("DE"));
+        model.setCurrentDateTime({{2018, 3, 1}, {12, 0}});
+        model.setWindowed(true);
+        model.setReservationManager(&resMgr);
+        model.setTransferManager(&transferMgr);
+        model.setTripGroupManager(&groupMgr);
+        model.setTripGroupId(tgId);
+        Test::waitForReset(&model);
+        QVERIFY(model.rowCount() > 0);
+        QVERIFY(!model.canFetchMore({}));
+        // views rely on this to fetch earlier elements when already scrolled to the top
+        QVERIFY(!windowSpy.isEmpty());
+        QVERIFY(model.canFetchEarlier());
+
+        for (int i = 0; i < 12 && model.canFetchEarlier(); ++i) {
+            windowSpy.clear();
+            model.fetchEarlier();
+            QCOMPARE(windowSpy.size(), 1);
+        }
+        QVERIFY(!model.canFetchEarlier());
+        compareWithFreshModel(&model, &resMgr, &transferMgr, &groupMgr, tgId);
+        QVERIFY(!QTest::currentTestFailed());
+    }
+
     void testWeatherElements()
     {
         using namespace KItinerary;
@@ -352,12 +581,36 @@ private Q_SLOTS:
         QCOMPARE(fc.maximumTemperature(), 52.5597f);
 
         // check we get update signals for all weather elements
+        std::vector<WeatherTile> tiles;
+        for (int i = 0; i < model.rowCount(); ++i) {
+            if (model.index(i, 0).data(TimelineModel::ElementTypeRole) == TimelineElement::WeatherForecast) {
+                tiles.push_back(model.index(i, 0).data(TimelineModel::WeatherForecastRole).value<WeatherInformation>().forecast.tile());
+            }
+        }
         QSignalSpy spy(&model, &TimelineModel::dataChanged);
         QVERIFY(spy.isValid());
-        Q_EMIT weatherMgr.forecastUpdated();
+        Q_EMIT weatherMgr.forecastTilesUpdated(tiles);
         QCOMPARE(model.rowCount(), 23);
         QCOMPARE(spy.size(), 9);
 
+        // updating a single tile only touches the weather elements referring to that
+        spy.clear();
+        const auto berlinTile = model.index(22, 0).data(TimelineModel::WeatherForecastRole).value<WeatherInformation>().forecast.tile();
+        Q_EMIT weatherMgr.forecastTilesUpdated({berlinTile});
+        QCOMPARE(model.rowCount(), 23);
+        QCOMPARE(spy.size(), (qsizetype)std::count(tiles.begin(), tiles.end(), berlinTile));
+        QVERIFY(spy.size() < 9);
+
+        // recomputing without any change in location context doesn't touch any weather element
+        spy.clear();
+        QSignalSpy insertSpy(&model, &TimelineModel::rowsInserted);
+        QSignalSpy removeSpy(&model, &TimelineModel::rowsRemoved);
+        Q_EMIT model.initialLocationChanged();
+        QCOMPARE(model.rowCount(), 23);
+        QCOMPARE(spy.size(), 0);
+        QCOMPARE(insertSpy.size(), 0);
+        QCOMPARE(removeSpy.size(), 0);
+
         // test case: two consecutive location changes, the first one to an unknown location
         // result: the weather element before the first location change ends with the start of that
         // result 2: we get a second weather element the same day after the second location change
@@ -485,6 +738,7 @@ private Q_SLOTS:
         const auto resId = model.index(0, 0).data(TimelineModel::BatchIdRole).toString();
         QVERIFY(!resId.isEmpty());
         const auto resIds = resMgr.reservationsForBatch(resId);
+        QCOMPARE(model.index(0, 0).data(TimelineModel::ReservationsRole).value<QList<QVariant>>().size(), 2);
         auto res = resMgr.reservation(resId).value<FlightReservation>();
         auto flight = res.reservationFor().value<Flight>();
         flight.setDepartureTime(flight.departureTime().addDays(1));
@@ -499,6 +753,22 @@ private Q_SLOTS:
         QCOMPARE(insertSpy.count(), 3);
         QCOMPARE(rmSpy.count(), 2);
 
+        // cached reservation data got updated as well
+        bool found = false;
+        for (int i = 0; i < model.rowCount(); ++i) {
+            const auto idx = model.index(i, 0);
+            if (idx.data(TimelineModel::BatchIdRole).toString() != resId) {
+                continue;
+            }
+            found = true;
+            const auto reservations = idx.data(TimelineModel::ReservationsRole).value<QList<QVariant>>();
+            QVERIFY(!reservations.isEmpty());
+            QVERIFY(std::any_of(reservations.begin(), reservations.end(), [&flight](const auto &r) {
+                return r.template value<FlightReservation>().reservationFor().template value<Flight>().departureTime() == flight.departureTime();
+            }));
+        }
+        QVERIFY(found);
+
         // update merges two elements
         updateSpy.clear();
         insertSpy.clear();
@@ -576,6 +846,62 @@ private Q_SLOTS:
         QVERIFY(vp3.verify(&model));
     }
 
+    void testCurrentElement()
+    {
+        ReservationManager resMgr;
+        Test::clearAll(&resMgr);
+        auto ctrl = Test::makeAppController();
+        ctrl->setReservationManager(&resMgr);
+        TransferManager::clear();
+        TransferManager transferMgr;
+        TripGroupManager groupMgr;
+        groupMgr.setReservationManager(&resMgr);
+        groupMgr.setTransferManager(&transferMgr);
+        ctrl->setTripGroupManager(&groupMgr);
+
+        ImportController importer;
+        importer.setReservationManager(&resMgr);
+        importer.importFromUrl(QUrl::fromLocalFile(QLatin1StringView(SOURCE_DIR "/../tests/randa2017.json")));
+        importer.setTripGroupName(u"Randa 2017"_s);
+        ctrl->commitImport(&importer);
+        QCOMPARE(groupMgr.tripGroups().size(), 1);
+
+        // during the first flight
+        const QTimeZone tz("Europe/Zurich");
+        TimelineModel model;
+        QAbstractItemModelTester tester(&model);
+        model.setHomeCountryIsoCode(QStringLiteral("DE"));
+        model.setCurrentDateTime(QDateTime({2017, 9, 10}, {7, 30}, tz));
+        model.setReservationManager(&resMgr);
+        model.setTransferManager(&transferMgr);
+        model.setTripGroupManager(&groupMgr);
+        model.setTripGroupId(groupMgr.tripGroups()[0]);
+        Test::waitForReset(&model);
+
+        // today marker is placed before the ongoing flight, and found by binary search
+        const auto todayRow = model.todayRow();
+        QVERIFY(todayRow >= 0);
+        QCOMPARE(model.index(todayRow, 0).data(TimelineModel::ElementTypeRole), TimelineElement::TodayMarker);
+        for (int i = 0; i < model.rowCount(); ++i) {
+            QCOMPARE(model.index(i, 0).data(TimelineModel::ElementTypeRole).toInt() == TimelineElement::TodayMarker, i == todayRow);
+        }
+
+        const auto flightRow = todayRow + 1;
+        QCOMPARE(model.index(flightRow, 0).data(TimelineModel::ElementTypeRole), TimelineElement::Flight);
+        QCOMPARE(model.index(flightRow, 0).data(TimelineModel::IsCurrentRole).toBool(), true);
+        for (int i = flightRow + 1; i < model.rowCount(); ++i) {
+            QCOMPARE(model.index(i, 0).data(TimelineModel::IsCurrentRole).toBool(), false);
+        }
+
+        QCOMPARE(model.firstRowAtOrAfter(QDateTime({2017, 9, 10}, {6, 45}, QTimeZone("Europe/Berlin"))), todayRow);
+        QCOMPARE(model.firstRowAtOrAfter(QDateTime({2017, 9, 1}, {0, 0}, tz)), 0);
+        QCOMPARE(model.firstRowAtOrAfter(QDateTime({2018, 1, 1}, {0, 0}, tz)), model.rowCount());
+
+        // after the flight
+        model.setCurrentDateTime(QDateTime({2017, 9, 10}, {9, 0}, tz));
+        QCOMPARE(model.index(flightRow, 0).data(TimelineModel::IsCurrentRole).toBool(), false);
+    }
+
     void testContent_data()
     {
         QTest::addColumn<QString>("baseName");
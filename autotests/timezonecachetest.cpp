@@ -0,0 +1,77 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "timezonecache.h"
+
+#include <QDateTime>
+#include <QTimeZone>
+#include <QtTest/qtest.h>
+
+using namespace Qt::Literals;
+
+class TimeZoneCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testTimeZone()
+    {
+        const auto tz = TimeZoneCache::timeZone("Europe/Berlin");
+        QVERIFY(tz.isValid());
+        QCOMPARE(tz.id(), "Europe/Berlin");
+        QCOMPARE(TimeZoneCache::timeZone("Europe/Berlin"), tz);
+        QVERIFY(!TimeZoneCache::timeZone({}).isValid());
+        QVERIFY(!TimeZoneCache::timeZone("Not/A_Zone").isValid());
+    }
+
+    void testLookup_data()
+    {
+        QTest::addColumn<QByteArray>("tzId");
+        QTest::newRow("Berlin") << "Europe/Berlin"_ba;
+        QTest::newRow("New York") << "America/New_York"_ba;
+        QTest::newRow("Sydney") << "Australia/Sydney"_ba;
+        QTest::newRow("Tokyo") << "Asia/Tokyo"_ba;
+        QTest::newRow("Lord Howe") << "Australia/Lord_Howe"_ba;
+    }
+
+    void testLookup()
+    {
+        QFETCH(QByteArray, tzId);
+        const QTimeZone tz(tzId);
+        QVERIFY(tz.isValid());
+        QCOMPARE(TimeZoneCache::hasDaylightTimeTransitions(tz), tz.hasDaylightTime() && tz.hasTransitions());
+
+        // in hour steps across two years, starting from the middle to exercise extending the cached range in both directions
+        const QDateTime center({2026, 1, 1}, {0, 30}, QTimeZone::UTC);
+        for (int i = 0; i < 365 * 24; i += 7) {
+            for (const auto &dt : {center.addSecs(i * 3600), center.addSecs(-i * 3600)}) {
+                QCOMPARE(TimeZoneCache::offsetFromUtc(tz, dt), tz.offsetFromUtc(dt));
+                QCOMPARE(TimeZoneCache::abbreviation(tz, dt), tz.abbreviation(dt));
+                QCOMPARE(TimeZoneCache::isDaylightTime(tz, dt), tz.isDaylightTime(dt));
+                QCOMPARE(TimeZoneCache::nextTransition(tz, dt).atUtc, tz.nextTransition(dt).atUtc);
+            }
+        }
+
+        // exactly at a transition
+        const auto transition = tz.nextTransition(center);
+        if (transition.atUtc.isValid()) {
+            QCOMPARE(TimeZoneCache::offsetFromUtc(tz, transition.atUtc), tz.offsetFromUtc(transition.atUtc));
+            QCOMPARE(TimeZoneCache::offsetFromUtc(tz, transition.atUtc.addSecs(-1)), tz.offsetFromUtc(transition.atUtc.addSecs(-1)));
+            QCOMPARE(TimeZoneCache::nextTransition(tz, transition.atUtc).atUtc, tz.nextTransition(transition.atUtc).atUtc);
+        }
+    }
+
+    void testNonCacheable()
+    {
+        const auto dt = QDateTime({2026, 7, 1}, {12, 0}, QTimeZone::UTC);
+        QCOMPARE(TimeZoneCache::offsetFromUtc(QTimeZone::UTC, dt), 0);
+        QCOMPARE(TimeZoneCache::offsetFromUtc(QTimeZone::fromSecondsAheadOfUtc(3600), dt), 3600);
+        QCOMPARE(TimeZoneCache::offsetFromUtc(QTimeZone(), dt), 0);
+        QVERIFY(!TimeZoneCache::hasDaylightTimeTransitions(QTimeZone::UTC));
+    }
+};
+
+QTEST_GUILESS_MAIN(TimeZoneCacheTest)
+
+#include "timezonecachetest.moc"
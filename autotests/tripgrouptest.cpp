@@ -22,6 +22,9 @@
 #include <QTemporaryFile>
 #include <QtTest/qtest.h>
 
+#include <algorithm>
+#include <set>
+
 using namespace Qt::Literals::StringLiterals;
 
 void initLocale()
@@ -804,6 +807,62 @@ private Q_SLOTS:
         QVERIFY(!tg.name().isEmpty());
     }
 
+    void testIncrementalScan()
+    {
+        ReservationManager resMgr;
+        TransferManager transferMgr;
+        Test::clearAll(&resMgr);
+        auto ctrl = Test::makeAppController();
+        ctrl->setReservationManager(&resMgr);
+        ImportController importer;
+        importer.setReservationManager(&resMgr);
+
+        const auto groupElements = [](const TripGroupManager &mgr, const QString &batchId = {}, const QString &replacementId = {}) {
+            std::set<QStringList> groups;
+            for (const auto &tgId : mgr.tripGroups()) {
+                auto elems = mgr.tripGroup(tgId).elements();
+                std::ranges::replace(elems, batchId, replacementId);
+                groups.insert(elems);
+            }
+            return groups;
+        };
+
+        std::set<QStringList> incrementalGroups;
+        {
+            TripGroupManager mgr;
+            mgr.setReservationManager(&resMgr);
+            mgr.setTransferManager(&transferMgr);
+            ctrl->setTripGroupManager(&mgr);
+
+            // two separate trips, grouped incrementally when imported on top of each other
+            importer.importFromUrl(QUrl::fromLocalFile(QLatin1StringView(SOURCE_DIR "/../tests/randa2017.json")));
+            ctrl->commitImport(&importer);
+            importer.importFromUrl(QUrl::fromLocalFile(QLatin1StringView(SOURCE_DIR "/data/google-multi-passenger-flight.json")));
+            ctrl->commitImport(&importer);
+            QCOMPARE(mgr.tripGroups().size(), 2);
+            incrementalGroups = groupElements(mgr);
+
+            // removing and re-adding an element in the middle of a trip restores the previous grouping
+            const auto &batches = resMgr.batches();
+            const auto batchId = batches[batches.size() / 2];
+            const auto res = resMgr.reservation(batchId);
+            resMgr.removeBatch(batchId);
+            const auto newResIds = resMgr.addReservations({res});
+            QCOMPARE(newResIds.size(), 1);
+            const auto newBatchId = resMgr.batchForReservation(newResIds.constFirst());
+            QCOMPARE(groupElements(mgr, newBatchId, batchId), incrementalGroups);
+            incrementalGroups = groupElements(mgr);
+            ctrl->setTripGroupManager(nullptr);
+        }
+
+        // same result as a full scan
+        TripGroupManager::clear();
+        TripGroupManager mgr;
+        mgr.setReservationManager(&resMgr);
+        mgr.setTransferManager(&transferMgr);
+        QCOMPARE(groupElements(mgr), incrementalGroups);
+    }
+
     void testNestedEvents()
     {
         ReservationManager resMgr;
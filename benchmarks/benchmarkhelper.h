@@ -0,0 +1,69 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef BENCHMARKHELPER_H
+#define BENCHMARKHELPER_H
+
+#include "filewritequeue.h"
+#include "profilegenerator.h"
+
+#include <QDir>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QtTest/qtest.h>
+
+namespace Benchmark
+{
+
+/** Initialize the benchmark environment, call from initTestCase(). */
+inline void init()
+{
+    qputenv("LC_ALL", "en_US.utf-8");
+    qputenv("TZ", "Europe/Berlin");
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+/** Adds one data row per profile size to benchmark.
+ *  Sizes can be overridden by setting ITINERARY_BENCHMARK_SIZES to a comma-separated list.
+ */
+inline void addProfileSizes()
+{
+    QTest::addColumn<int>("size");
+    const auto sizes = qEnvironmentVariable("ITINERARY_BENCHMARK_SIZES", QStringLiteral("100,1000,10000")).split(QLatin1Char(','));
+    for (const auto &size : sizes) {
+        QTest::newRow(qPrintable(size.trimmed())) << size.trimmed().toInt();
+    }
+}
+
+/** Size of the currently stored generated profile, -1 if none. */
+inline int &currentProfileSize()
+{
+    static int s_currentSize = -1;
+    return s_currentSize;
+}
+
+/** Delete all stored data. */
+inline void clearProfile()
+{
+    FileWriteQueue::flush();
+    QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).removeRecursively();
+    QSettings().clear();
+    currentProfileSize() = -1;
+}
+
+/** Makes sure the stored profile has been generated for @p size reservations. */
+inline void ensureProfile(int size)
+{
+    if (currentProfileSize() == size) {
+        return;
+    }
+    clearProfile();
+    ProfileGenerator::generate({.reservationCount = size});
+    currentProfileSize() = size;
+}
+
+}
+
+#endif // BENCHMARKHELPER_H
@@ -0,0 +1,82 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "benchmarkhelper.h"
+
+#include "reservationmanager.h"
+
+#include <QtTest/qtest.h>
+
+using namespace Qt::Literals;
+
+class ReservationManagerBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase()
+    {
+        Benchmark::init();
+    }
+
+    void benchmarkAddReservation_data()
+    {
+        Benchmark::addProfileSizes();
+    }
+    void benchmarkAddReservation()
+    {
+        QFETCH(int, size);
+        const auto reservations = ProfileGenerator::reservations({.reservationCount = size});
+        Benchmark::clearProfile();
+
+        ReservationManager mgr;
+        QBENCHMARK_ONCE {
+            for (const auto &res : reservations) {
+                mgr.addReservation(res);
+            }
+        }
+        FileWriteQueue::flush();
+    }
+
+    void benchmarkAddReservations_data()
+    {
+        Benchmark::addProfileSizes();
+    }
+    void benchmarkAddReservations()
+    {
+        QFETCH(int, size);
+        const auto reservations = ProfileGenerator::reservations({.reservationCount = size});
+        Benchmark::clearProfile();
+
+        ReservationManager mgr;
+        QBENCHMARK_ONCE {
+            mgr.addReservations(reservations);
+        }
+        FileWriteQueue::flush();
+    }
+
+    void benchmarkLoad_data()
+    {
+        Benchmark::addProfileSizes();
+    }
+    void benchmarkLoad()
+    {
+        QFETCH(int, size);
+        Benchmark::ensureProfile(size);
+
+        QBENCHMARK {
+            ReservationManager mgr;
+            QVERIFY(!mgr.batches().empty());
+        }
+    }
+
+    void cleanupTestCase()
+    {
+        Benchmark::clearProfile();
+    }
+};
+
+QTEST_GUILESS_MAIN(ReservationManagerBenchmark)
+
+#include "reservationmanagerbenchmark.moc"
@@ -0,0 +1,61 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "benchmarkhelper.h"
+
+#include "reservationmanager.h"
+#include "statisticsmodel.h"
+#include "transfermanager.h"
+#include "tripgroupmanager.h"
+
+#include <QtTest/qtest.h>
+
+class StatisticsModelBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase()
+    {
+        Benchmark::init();
+    }
+
+    void benchmarkRecompute_data()
+    {
+        Benchmark::addProfileSizes();
+    }
+    void benchmarkRecompute()
+    {
+        QFETCH(int, size);
+        Benchmark::ensureProfile(size);
+        ReservationManager resMgr;
+        TransferManager transferMgr;
+        transferMgr.setReservationManager(&resMgr);
+        TripGroupManager tgMgr;
+        tgMgr.setReservationManager(&resMgr);
+        tgMgr.setTransferManager(&transferMgr);
+
+        StatisticsModel model;
+        model.setReservationManager(&resMgr);
+        model.setTripGroupManager(&tgMgr);
+        model.setTransferManager(&transferMgr);
+
+        // changing the time range triggers a full recomputation
+        const auto today = QDate::currentDate();
+        bool allTime = false;
+        QBENCHMARK {
+            allTime = !allTime;
+            model.setTimeRange(allTime ? QDate() : today.addYears(-1), allTime ? QDate() : today);
+        }
+    }
+
+    void cleanupTestCase()
+    {
+        Benchmark::clearProfile();
+    }
+};
+
+QTEST_GUILESS_MAIN(StatisticsModelBenchmark)
+
+#include "statisticsmodelbenchmark.moc"
@@ -0,0 +1,66 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "benchmarkhelper.h"
+
+#include "reservationmanager.h"
+#include "timelinemodel.h"
+#include "transfermanager.h"
+#include "tripgroupmanager.h"
+
+#include <QSignalSpy>
+#include <QtTest/qtest.h>
+
+class TimelineModelBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase()
+    {
+        Benchmark::init();
+    }
+
+    void benchmarkPopulate_data()
+    {
+        Benchmark::addProfileSizes();
+    }
+    void benchmarkPopulate()
+    {
+        QFETCH(int, size);
+        Benchmark::ensureProfile(size);
+        ReservationManager resMgr;
+        TransferManager transferMgr;
+        transferMgr.setReservationManager(&resMgr);
+        TripGroupManager tgMgr;
+        tgMgr.setReservationManager(&resMgr);
+        tgMgr.setTransferManager(&transferMgr);
+
+        // a trip in the middle of the profile, reservations are cached after the first iteration
+        const auto &batches = resMgr.batches();
+        QVERIFY(!batches.empty());
+        const auto tgId = tgMgr.tripGroupIdForReservation(batches[batches.size() / 2]);
+        QVERIFY(!tgId.isEmpty());
+
+        QBENCHMARK {
+            TimelineModel model;
+            QSignalSpy resetSpy(&model, &TimelineModel::modelReset);
+            model.setReservationManager(&resMgr);
+            model.setTransferManager(&transferMgr);
+            model.setTripGroupManager(&tgMgr);
+            model.setTripGroupId(tgId);
+            QVERIFY(!resetSpy.isEmpty() || resetSpy.wait());
+            QVERIFY(model.rowCount() > 0);
+        }
+    }
+
+    void cleanupTestCase()
+    {
+        Benchmark::clearProfile();
+    }
+};
+
+QTEST_GUILESS_MAIN(TimelineModelBenchmark)
+
+#include "timelinemodelbenchmark.moc"
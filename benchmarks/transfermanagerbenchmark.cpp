@@ -0,0 +1,64 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "benchmarkhelper.h"
+
+#include "favoritelocationmodel.h"
+#include "livedatamanager.h"
+#include "reservationmanager.h"
+#include "transfermanager.h"
+
+#include <QtTest/qtest.h>
+
+using namespace Qt::Literals;
+
+class TransferManagerBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase()
+    {
+        Benchmark::init();
+    }
+
+    // full rescan, as done on first start or after adding a home location
+    void benchmarkRescan_data()
+    {
+        Benchmark::addProfileSizes();
+    }
+    void benchmarkRescan()
+    {
+        QFETCH(int, size);
+        Benchmark::ensureProfile(size);
+        ReservationManager resMgr;
+        LiveDataManager liveDataMgr;
+
+        FavoriteLocation home;
+        home.setName(u"Home"_s);
+        home.setLatitude(52.52);
+        home.setLongitude(13.40);
+        FavoriteLocationModel favLocModel;
+        favLocModel.setFavoriteLocations({home});
+
+        QBENCHMARK {
+            QSettings().remove(u"TransferManager/FullScan"_s);
+            TransferManager transferMgr;
+            transferMgr.setAutoAddTransfers(true);
+            transferMgr.setReservationManager(&resMgr);
+            transferMgr.setLiveDataManager(&liveDataMgr);
+            transferMgr.setFavoriteLocationModel(&favLocModel);
+        }
+        FileWriteQueue::flush();
+    }
+
+    void cleanupTestCase()
+    {
+        Benchmark::clearProfile();
+    }
+};
+
+QTEST_GUILESS_MAIN(TransferManagerBenchmark)
+
+#include "transfermanagerbenchmark.moc"
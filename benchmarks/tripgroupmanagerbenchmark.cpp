@@ -0,0 +1,74 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "benchmarkhelper.h"
+
+#include "reservationmanager.h"
+#include "transfermanager.h"
+#include "tripgroupmanager.h"
+
+#include <QtTest/qtest.h>
+
+class TripGroupManagerBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase()
+    {
+        Benchmark::init();
+    }
+
+    // loading existing trip groups, with nothing left to group
+    void benchmarkLoad_data()
+    {
+        Benchmark::addProfileSizes();
+    }
+    void benchmarkLoad()
+    {
+        QFETCH(int, size);
+        Benchmark::ensureProfile(size);
+        ReservationManager resMgr;
+        TransferManager transferMgr;
+
+        QBENCHMARK {
+            TripGroupManager tgMgr;
+            tgMgr.setReservationManager(&resMgr);
+            tgMgr.setTransferManager(&transferMgr);
+            QVERIFY(!tgMgr.isEmpty());
+        }
+    }
+
+    // full scan for trip groups, as e.g. after an import or data migration
+    void benchmarkScanAll_data()
+    {
+        Benchmark::addProfileSizes();
+    }
+    void benchmarkScanAll()
+    {
+        QFETCH(int, size);
+        Benchmark::ensureProfile(size);
+        ReservationManager resMgr;
+        TransferManager transferMgr;
+
+        FileWriteQueue::flush();
+        TripGroupManager::clear();
+        QBENCHMARK_ONCE {
+            TripGroupManager tgMgr;
+            tgMgr.setReservationManager(&resMgr);
+            tgMgr.setTransferManager(&transferMgr);
+            QVERIFY(!tgMgr.isEmpty());
+        }
+        FileWriteQueue::flush();
+    }
+
+    void cleanupTestCase()
+    {
+        Benchmark::clearProfile();
+    }
+};
+
+QTEST_GUILESS_MAIN(TripGroupManagerBenchmark)
+
+#include "tripgroupmanagerbenchmark.moc"
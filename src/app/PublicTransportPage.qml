@@ -96,7 +96,7 @@ DetailsPage {
 
     Loader {
         id: sectionDetailsLoader
-        active: root.controller.journey && (root.controller.journey.from.name && root.controller.journey.to.name || root.controller.journey.intermediateStops.length > 0 || !root.controller.journey.path.isEmpty)
+        active: root.controller.journey && (root.controller.journey.from.name && root.controller.journey.to.name || root.controller.journey.intermediateStops.length > 0 || root.controller.hasPath)
         asynchronous: true
         sourceComponent: JourneySectionView {
             // Hack to prevent SwipeView from allowing to swipe to the details while not active
@@ -112,7 +112,7 @@ DetailsPage {
 
     Loader {
         id: mapLoader
-        active: root.controller.journey && (root.controller.journey.intermediateStops.length > 0 || !root.controller.journey.path.isEmpty)
+        active: root.controller.journey && (root.controller.journey.intermediateStops.length > 0 || root.controller.hasPath)
         asynchronous: true
 
         sourceComponent: JourneySectionMapView {
@@ -125,7 +125,7 @@ DetailsPage {
                                               : Kirigami.Units.largeSpacing
 
             id: map
-            journeySection: root.controller.trip
+            journeySection: root.controller.tripWithPath
 
             data: [
                 MapStopoverInfoSheetDrawer {
@@ -196,12 +196,12 @@ DetailsPage {
                 },
                 Kirigami.Action {
                     text: i18n("Journey")
-                    enabled: root.controller.journey && (root.controller.journey.from.name && root.controller.journey.to.name || root.controller.journey.intermediateStops.length > 0 || !root.controller.journey.path.isEmpty)
+                    enabled: root.controller.journey && (root.controller.journey.from.name && root.controller.journey.to.name || root.controller.journey.intermediateStops.length > 0 || root.controller.hasPath)
                     checked: view.currentIndex === 1
                 },
                 Kirigami.Action {
                     text: i18n("Map")
-                    enabled: root.controller.journey && (root.controller.journey.intermediateStops.length > 0 || !root.controller.journey.path.isEmpty)
+                    enabled: root.controller.journey && (root.controller.journey.intermediateStops.length > 0 || root.controller.hasPath)
                     checked: view.currentIndex === 2
                 }
             ]
@@ -25,6 +25,8 @@ FormCard.FormCard {
     /** Reservation::reservationFor, unique for all travelers on a multi-traveler reservation set */
     readonly property var reservationFor: reservation.reservationFor
     property var rangeType
+    /** The element has started but not ended yet. */
+    property bool isCurrent: false
 
     /** Details page to show when clicking the delegate. */
     property Component detailsPage: null
@@ -110,6 +112,7 @@ FormCard.FormCard {
     }
 
     Accessible.onPressAction: root.clicked()
+    Accessible.description: root.isCurrent ? i18nc("@info:whatsthis timeline element state", "Ongoing") : ""
 
     Connections {
         target: ReservationManager
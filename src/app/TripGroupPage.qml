@@ -404,6 +404,9 @@ Kirigami.ScrollablePage {
         tripGroupManager: TripGroupManager
         tripGroupId: root.tripGroupId
         initialLocation: TripGroupModel.locationAtTime(root.tripGroup.beginDateTime)
+        windowed: true
+        // re-check once the view has laid out the changed content
+        onWindowChanged: Qt.callLater(listView.fetchEarlierIfAtBeginning)
     }
 
     ListView {
@@ -558,6 +561,14 @@ Kirigami.ScrollablePage {
         }
 
         model: root.isEmptyTripGroup ? null : timelineModel
+        // later elements are loaded by ListView via fetchMore() automatically, earlier ones
+        // whenever we are at the beginning, which we already are initially for past trips
+        function fetchEarlierIfAtBeginning() {
+            if (listView.atYBeginning && timelineModel.canFetchEarlier) {
+                timelineModel.fetchEarlier();
+            }
+        }
+        onAtYBeginningChanged: listView.fetchEarlierIfAtBeginning()
 
         section {
             property: "sectionHeader"
@@ -572,6 +583,7 @@ Kirigami.ScrollablePage {
                 FlightDelegate {
                     batchId: model.batchId
                     rangeType: model.rangeType
+                    isCurrent: model.isCurrent
                     detailsPage: flightDetailsPage
                 }
             }
@@ -580,6 +592,7 @@ Kirigami.ScrollablePage {
                 HotelDelegate {
                     batchId: model.batchId
                     rangeType: model.rangeType
+                    isCurrent: model.isCurrent
                     detailsPage: hotelDetailsPage
                 }
             }
@@ -588,6 +601,7 @@ Kirigami.ScrollablePage {
                 TrainDelegate {
                     batchId: model.batchId
                     rangeType: model.rangeType
+                    isCurrent: model.isCurrent
                     detailsPage: trainDetailsPage
                 }
             }
@@ -596,6 +610,7 @@ Kirigami.ScrollablePage {
                 BusDelegate {
                     batchId: model.batchId
                     rangeType: model.rangeType
+                    isCurrent: model.isCurrent
                     detailsPage: busDetailsPage
                 }
             }
@@ -604,6 +619,7 @@ Kirigami.ScrollablePage {
                 RestaurantDelegate {
                     batchId: model.batchId
                     rangeType: model.rangeType
+                    isCurrent: model.isCurrent
                     detailsPage: restaurantDetailsPage
                 }
             }
@@ -612,6 +628,7 @@ Kirigami.ScrollablePage {
                 TouristAttractionDelegate {
                     batchId: model.batchId
                     rangeType: model.rangeType
+                    isCurrent: model.isCurrent
                     detailsPage: touristAttractionDetailsPage
                 }
             }
@@ -620,6 +637,7 @@ Kirigami.ScrollablePage {
                 EventDelegate {
                     batchId: model.batchId
                     rangeType: model.rangeType
+                    isCurrent: model.isCurrent
                     detailsPage: eventDetailsPage
                 }
             }
@@ -628,6 +646,7 @@ Kirigami.ScrollablePage {
                 CarRentalDelegate {
                     batchId: model.batchId
                     rangeType: model.rangeType
+                    isCurrent: model.isCurrent
                     detailsPage: carRentalDetailsPage
                 }
             }
@@ -636,6 +655,7 @@ Kirigami.ScrollablePage {
                 BoatDelegate {
                     batchId: model.batchId
                     rangeType: model.rangeType
+                    isCurrent: model.isCurrent
                     detailsPage: boatDetailsPage
                 }
             }
@@ -817,7 +837,10 @@ Kirigami.ScrollablePage {
         id: positionTimer
         interval: 10
         repeat: false
-        onTriggered: listView.positionViewAtIndex(timelineModel.todayRow, ListView.Beginning);
+        onTriggered: {
+            listView.positionViewAtIndex(timelineModel.todayRow, ListView.Beginning);
+            listView.fetchEarlierIfAtBeginning();
+        }
     }
 
     Component.onCompleted: positionTimer.start()
@@ -204,6 +204,7 @@ void ApplicationController::commitImport(ImportController *importController)
     int healthCertCount = 0;
 
     TripGroupingBlocker groupBlocker(m_tripGroupMgr);
+    ReservationBulkUpdate bulkUpdate(m_resMgr);
     QStringList tripGroupElements;
     for (const auto &elem : importController->elements()) {
         if (!elem.selected) {
@@ -459,7 +460,7 @@ void ApplicationController::exportTripToGpx(const QString &tripGroupId, const QU
         const auto res = m_resMgr->reservation(batchId);
         const auto transferBefore = m_transferMgr->transfer(batchId, Transfer::Before);
         const auto transferAfter = m_transferMgr->transfer(batchId, Transfer::After);
-        exporter.writeReservation(res, m_liveDataMgr->journey(batchId), transferBefore, transferAfter);
+        exporter.writeReservation(res, m_liveDataMgr->journeyWithPath(batchId), transferBefore, transferAfter);
     }
     Q_EMIT infoMessage(i18n("Export completed."));
 }
@@ -554,7 +555,7 @@ void ApplicationController::exportBatchToGpx(const QString &batchId, const QUrl
     const auto res = m_resMgr->reservation(batchId);
     const auto transferBefore = m_transferMgr->transfer(batchId, Transfer::Before);
     const auto transferAfter = m_transferMgr->transfer(batchId, Transfer::After);
-    exporter.writeReservation(res, m_liveDataMgr->journey(batchId), transferBefore, transferAfter);
+    exporter.writeReservation(res, m_liveDataMgr->journeyWithPath(batchId), transferBefore, transferAfter);
 
     Q_EMIT infoMessage(i18n("Export completed."));
 }
@@ -0,0 +1,253 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "batchindex.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+// invalid times sort first, same as for QDateTime
+[[nodiscard]] static qint64 toMSecs(const QDateTime &dt)
+{
+    return dt.isValid() ? dt.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+}
+
+BatchIndex::BatchIndex() = default;
+BatchIndex::~BatchIndex() = default;
+
+const std::vector<QString> &BatchIndex::batchIds() const
+{
+    return m_batchIds;
+}
+
+qsizetype BatchIndex::size() const
+{
+    return (qsizetype)m_batchIds.size();
+}
+
+bool BatchIndex::contains(const QString &batchId) const
+{
+    return m_keyById.contains(batchId);
+}
+
+void BatchIndex::clear()
+{
+    m_keys.clear();
+    m_batchIds.clear();
+    m_keyById.clear();
+    m_maxDuration = 0;
+}
+
+void BatchIndex::reserve(qsizetype size)
+{
+    m_keys.reserve(size);
+    m_batchIds.reserve(size);
+    m_keyById.reserve(size);
+}
+
+void BatchIndex::append(const QString &batchId, const QDateTime &startDt, const QDateTime &endDt)
+{
+    const auto key = makeKey(startDt, endDt);
+    m_keys.push_back(key);
+    m_batchIds.push_back(batchId);
+    m_keyById.insert(batchId, key);
+    updateMaximumDuration(key);
+}
+
+void BatchIndex::sort()
+{
+    std::vector<std::size_t> order(m_batchIds.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, [this](auto lhs, auto rhs) {
+        return isBefore(m_keys[lhs], m_batchIds[lhs], m_keys[rhs], m_batchIds[rhs]);
+    });
+
+    std::vector<Key> keys;
+    keys.reserve(order.size());
+    std::vector<QString> batchIds;
+    batchIds.reserve(order.size());
+    for (auto i : order) {
+        keys.push_back(m_keys[i]);
+        batchIds.push_back(std::move(m_batchIds[i]));
+    }
+    m_keys = std::move(keys);
+    m_batchIds = std::move(batchIds);
+}
+
+void BatchIndex::insert(const QString &batchId, const QDateTime &startDt, const QDateTime &endDt)
+{
+    Q_ASSERT(!contains(batchId));
+    const auto key = makeKey(startDt, endDt);
+    const auto pos = position(key, batchId);
+    m_keys.insert(m_keys.begin() + pos, key);
+    m_batchIds.insert(m_batchIds.begin() + pos, batchId);
+    m_keyById.insert(batchId, key);
+    updateMaximumDuration(key);
+}
+
+void BatchIndex::update(const QString &batchId, const QDateTime &startDt, const QDateTime &endDt)
+{
+    const auto oldPos = indexOf(batchId);
+    if (oldPos < 0) {
+        insert(batchId, startDt, endDt);
+        return;
+    }
+
+    const auto key = makeKey(startDt, endDt);
+    m_keyById.insert(batchId, key);
+    updateMaximumDuration(key);
+
+    // move to the new position, which only shifts the elements in between
+    auto newPos = position(key, batchId);
+    if (newPos > oldPos) {
+        --newPos; // we are still in the range before newPos
+        std::rotate(m_keys.begin() + oldPos, m_keys.begin() + oldPos + 1, m_keys.begin() + newPos + 1);
+        std::rotate(m_batchIds.begin() + oldPos, m_batchIds.begin() + oldPos + 1, m_batchIds.begin() + newPos + 1);
+    } else if (newPos < oldPos) {
+        std::rotate(m_keys.begin() + newPos, m_keys.begin() + oldPos, m_keys.begin() + oldPos + 1);
+        std::rotate(m_batchIds.begin() + newPos, m_batchIds.begin() + oldPos, m_batchIds.begin() + oldPos + 1);
+    }
+    m_keys[newPos] = key;
+}
+
+void BatchIndex::rename(const QString &oldBatchId, const QString &newBatchId)
+{
+    const auto key = m_keyById.value(oldBatchId);
+    const auto pos = indexOf(oldBatchId);
+    if (pos < 0) {
+        return;
+    }
+
+    // the id is part of the sort order, so this can require moving the batch
+    m_keys.erase(m_keys.begin() + pos);
+    m_batchIds.erase(m_batchIds.begin() + pos);
+    m_keyById.remove(oldBatchId);
+
+    const auto newPos = position(key, newBatchId);
+    m_keys.insert(m_keys.begin() + newPos, key);
+    m_batchIds.insert(m_batchIds.begin() + newPos, newBatchId);
+    m_keyById.insert(newBatchId, key);
+}
+
+void BatchIndex::remove(const QString &batchId)
+{
+    const auto pos = indexOf(batchId);
+    if (pos < 0) {
+        return;
+    }
+    m_keys.erase(m_keys.begin() + pos);
+    m_batchIds.erase(m_batchIds.begin() + pos);
+    m_keyById.remove(batchId);
+}
+
+qsizetype BatchIndex::indexOf(const QString &batchId) const
+{
+    const auto it = m_keyById.constFind(batchId);
+    if (it == m_keyById.constEnd()) {
+        return -1;
+    }
+
+    const auto pos = position(it.value(), batchId);
+    if (pos >= size() || m_batchIds[pos] != batchId) {
+        Q_ASSERT_X(false, "BatchIndex::indexOf", "batch index out of order");
+        const auto findIt = std::ranges::find(m_batchIds, batchId);
+        return findIt == m_batchIds.end() ? -1 : std::distance(m_batchIds.begin(), findIt);
+    }
+    return pos;
+}
+
+qsizetype BatchIndex::lowerBound(const QDateTime &dt) const
+{
+    const auto msecs = toMSecs(dt);
+    const auto it = std::ranges::partition_point(m_keys, [msecs](const auto &key) {
+        return key.start < msecs;
+    });
+    return std::distance(m_keys.begin(), it);
+}
+
+QString BatchIndex::previous(const QString &batchId) const
+{
+    const auto pos = indexOf(batchId);
+    if (pos <= 0) {
+        return {};
+    }
+    return m_batchIds[pos - 1];
+}
+
+QString BatchIndex::next(const QString &batchId) const
+{
+    const auto pos = indexOf(batchId);
+    if (pos < 0 || pos + 1 >= size()) {
+        return {};
+    }
+    return m_batchIds[pos + 1];
+}
+
+std::vector<QString> BatchIndex::overlapping(const QDateTime &begin, const QDateTime &end) const
+{
+    std::vector<QString> result;
+    if (!begin.isValid()) {
+        return result;
+    }
+
+    // nothing starting before this can still overlap with begin
+    const auto beginMSecs = begin.toMSecsSinceEpoch();
+    const auto endMSecs = end.isValid() ? end.toMSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+    const auto it = std::ranges::partition_point(m_keys, [beginMSecs, this](const auto &key) {
+        return key.start < beginMSecs - m_maxDuration;
+    });
+
+    for (auto i = std::distance(m_keys.begin(), it); i < size() && m_keys[i].start <= endMSecs; ++i) {
+        const auto &key = m_keys[i];
+        if (key.start == std::numeric_limits<qint64>::min()) {
+            continue;
+        }
+        if (std::max(key.start, key.end) >= beginMSecs) {
+            result.push_back(m_batchIds[i]);
+        }
+    }
+    return result;
+}
+
+BatchIndex::Key BatchIndex::makeKey(const QDateTime &startDt, const QDateTime &endDt)
+{
+    return {.start = toMSecs(startDt), .end = toMSecs(endDt)};
+}
+
+bool BatchIndex::isBefore(Key lhsKey, const QString &lhsId, Key rhsKey, const QString &rhsId)
+{
+    if (lhsKey.start != rhsKey.start) {
+        return lhsKey.start < rhsKey.start;
+    }
+    if (lhsKey.end != rhsKey.end) {
+        return lhsKey.end > rhsKey.end;
+    }
+    return lhsId < rhsId;
+}
+
+qsizetype BatchIndex::position(Key key, const QString &batchId) const
+{
+    qsizetype begin = 0;
+    qsizetype end = size();
+    while (begin < end) {
+        const auto mid = begin + (end - begin) / 2;
+        if (isBefore(m_keys[mid], m_batchIds[mid], key, batchId)) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    return begin;
+}
+
+void BatchIndex::updateMaximumDuration(Key key)
+{
+    if (key.start != std::numeric_limits<qint64>::min() && key.end != std::numeric_limits<qint64>::min()) {
+        m_maxDuration = std::max(m_maxDuration, key.end - key.start);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef BATCHINDEX_H
+#define BATCHINDEX_H
+
+#include <QHash>
+#include <QString>
+
+#include <vector>
+
+class QDateTime;
+
+/** Time-ordered index of reservation batches.
+ *  Batches are sorted by start time, then by descending end time (ie. the same
+ *  order as ReservationBatch::isBefore), and by id for otherwise equal batches.
+ *  Start and end times are kept in a contiguous array next to the ids, so searching
+ *  doesn't need any hash lookups, the position of a given batch is found by binary search.
+ */
+class BatchIndex
+{
+public:
+    BatchIndex();
+    ~BatchIndex();
+
+    /** All batch ids, in order. */
+    [[nodiscard]] const std::vector<QString> &batchIds() const;
+    [[nodiscard]] qsizetype size() const;
+    [[nodiscard]] bool contains(const QString &batchId) const;
+
+    void clear();
+    void reserve(qsizetype size);
+    /** Add a batch without maintaining the sort order, for bulk loading.
+     *  Call sort() once done.
+     */
+    void append(const QString &batchId, const QDateTime &startDt, const QDateTime &endDt);
+    void sort();
+
+    /** Add a new batch. */
+    void insert(const QString &batchId, const QDateTime &startDt, const QDateTime &endDt);
+    /** Update start and/or end times of an existing batch, moving it if necessary. */
+    void update(const QString &batchId, const QDateTime &startDt, const QDateTime &endDt);
+    void rename(const QString &oldBatchId, const QString &newBatchId);
+    void remove(const QString &batchId);
+
+    /** Position of @p batchId in batchIds(), or -1 if not present. */
+    [[nodiscard]] qsizetype indexOf(const QString &batchId) const;
+    /** Position of the first batch starting at or after @p dt. */
+    [[nodiscard]] qsizetype lowerBound(const QDateTime &dt) const;
+
+    [[nodiscard]] QString previous(const QString &batchId) const;
+    [[nodiscard]] QString next(const QString &batchId) const;
+
+    /** All batches overlapping with the time range [@p begin, @p end], in order.
+     *  Batches without a valid end time are considered to end at their start time.
+     *  An invalid @p end means the range is open-ended.
+     */
+    [[nodiscard]] std::vector<QString> overlapping(const QDateTime &begin, const QDateTime &end) const;
+
+private:
+    struct Key {
+        qint64 start = 0;
+        qint64 end = 0;
+    };
+    [[nodiscard]] static Key makeKey(const QDateTime &startDt, const QDateTime &endDt);
+    [[nodiscard]] static bool isBefore(Key lhsKey, const QString &lhsId, Key rhsKey, const QString &rhsId);
+    /** Insertion position for the given batch. */
+    [[nodiscard]] qsizetype position(Key key, const QString &batchId) const;
+    void updateMaximumDuration(Key key);
+
+    std::vector<Key> m_keys;
+    std::vector<QString> m_batchIds;
+    QHash<QString, Key> m_keyById;
+    qint64 m_maxDuration = 0; // for overlap queries
+};
+
+#endif // BATCHINDEX_H
@@ -0,0 +1,144 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "deadlinescheduler.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+
+#include <algorithm>
+
+DeadlineScheduler::DeadlineScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QChronoTimer::timeout, this, &DeadlineScheduler::processExpired);
+}
+
+DeadlineScheduler::~DeadlineScheduler()
+{
+    for (const auto &sub : std::as_const(m_subscriptions)) {
+        disconnect(sub.destroyedConnection);
+    }
+}
+
+DeadlineScheduler *DeadlineScheduler::instance()
+{
+    static DeadlineScheduler *s_instance = nullptr;
+    if (!s_instance) {
+        s_instance = new DeadlineScheduler(QCoreApplication::instance());
+    }
+    return s_instance;
+}
+
+void DeadlineScheduler::schedule(QObject *subscriber, const QDateTime &deadline, std::function<void()> &&callback, std::chrono::milliseconds slack)
+{
+    auto msecs = deadline.toMSecsSinceEpoch();
+    if (slack.count() > 0) {
+        msecs = ((msecs + slack.count() - 1) / slack.count()) * slack.count();
+    }
+
+    auto it = m_subscriptions.find(subscriber);
+    if (it == m_subscriptions.end()) {
+        it = m_subscriptions.insert(subscriber, {});
+        (*it).destroyedConnection = connect(subscriber, &QObject::destroyed, this, [this](QObject *obj) {
+            // this is called after the subscriber has been destroyed, so we must not disconnect from it anymore
+            m_subscriptions.remove(obj);
+        });
+    } else if ((*it).deadline == msecs) {
+        (*it).callback = std::move(callback);
+        return;
+    }
+
+    (*it).deadline = msecs;
+    (*it).callback = std::move(callback);
+    m_heap.push_back({msecs, subscriber});
+    std::push_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+
+    // drop stale heap entries if they make up the majority of the heap
+    if (m_heap.size() > 2 * (std::size_t)m_subscriptions.size() + 16) {
+        std::erase_if(m_heap, [this](const auto &entry) {
+            const auto subIt = m_subscriptions.constFind(entry.subscriber);
+            return subIt == m_subscriptions.constEnd() || (*subIt).deadline != entry.deadline;
+        });
+        std::make_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+    }
+
+    if (m_heap.front().subscriber == subscriber && m_heap.front().deadline == msecs) {
+        scheduleTimer();
+    }
+}
+
+void DeadlineScheduler::cancel(QObject *subscriber)
+{
+    const auto it = m_subscriptions.find(subscriber);
+    if (it != m_subscriptions.end()) {
+        remove(it);
+    }
+}
+
+bool DeadlineScheduler::isScheduled(const QObject *subscriber) const
+{
+    return m_subscriptions.contains(const_cast<QObject *>(subscriber));
+}
+
+qsizetype DeadlineScheduler::size() const
+{
+    return m_subscriptions.size();
+}
+
+void DeadlineScheduler::remove(QHash<QObject *, Subscription>::iterator it)
+{
+    disconnect((*it).destroyedConnection);
+    m_subscriptions.erase(it);
+}
+
+void DeadlineScheduler::processExpired()
+{
+    const auto now = QDateTime::currentMSecsSinceEpoch();
+    while (!m_heap.empty() && m_heap.front().deadline <= now) {
+        const auto entry = m_heap.front();
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+        m_heap.pop_back();
+
+        const auto it = m_subscriptions.find(entry.subscriber);
+        if (it == m_subscriptions.end() || (*it).deadline != entry.deadline) {
+            continue; // rescheduled or cancelled
+        }
+        // the callback might reschedule the subscriber
+        const auto callback = std::move((*it).callback);
+        remove(it);
+        callback();
+    }
+
+    scheduleTimer();
+}
+
+void DeadlineScheduler::scheduleTimer()
+{
+    // skip stale entries, so we don't wake up for nothing
+    while (!m_heap.empty()) {
+        const auto it = m_subscriptions.constFind(m_heap.front().subscriber);
+        if (it != m_subscriptions.constEnd() && (*it).deadline == m_heap.front().deadline) {
+            break;
+        }
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+        m_heap.pop_back();
+    }
+
+    if (m_heap.empty()) {
+        m_timer.stop();
+        return;
+    }
+
+    // the timer might fire early due to its coarse resolution, processExpired() then just reschedules
+    // very coarse timers round to full seconds, that would busy-loop for short intervals though
+    const auto interval = std::chrono::milliseconds(std::max<qint64>(0, m_heap.front().deadline - QDateTime::currentMSecsSinceEpoch()));
+    m_timer.setTimerType(interval < std::chrono::minutes(1) ? Qt::CoarseTimer : Qt::VeryCoarseTimer);
+    m_timer.setInterval(interval);
+    m_timer.start();
+}
+
+#include "moc_deadlinescheduler.cpp"
@@ -0,0 +1,76 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef DEADLINESCHEDULER_H
+#define DEADLINESCHEDULER_H
+
+#include <QChronoTimer>
+#include <QHash>
+#include <QObject>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+class QDateTime;
+
+/** Wakes up a potentially large number of objects at individual points in time,
+ *  using a single timer.
+ *  Deadlines are kept in a min-heap, so only the subscribers whose deadline expired
+ *  are called when the timer fires. This is meant for e.g. timeline delegates that
+ *  need to update when the element they show starts or ends.
+ */
+class DeadlineScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DeadlineScheduler(QObject *parent = nullptr);
+    ~DeadlineScheduler() override;
+
+    /** Process-wide instance. */
+    [[nodiscard]] static DeadlineScheduler *instance();
+
+    /** Call @p callback once @p deadline has been reached.
+     *  This replaces a deadline previously scheduled for @p subscriber. Deadlines
+     *  are automatically cancelled when @p subscriber is destroyed.
+     *  @param slack The deadline is rounded up to a multiple of this, so that deadlines
+     *  close to each other are handled in one go. Callbacks are never called early.
+     */
+    void schedule(QObject *subscriber, const QDateTime &deadline, std::function<void()> &&callback, std::chrono::milliseconds slack = {});
+    /** Cancel the deadline of @p subscriber, if any. */
+    void cancel(QObject *subscriber);
+
+    [[nodiscard]] bool isScheduled(const QObject *subscriber) const;
+    /** Number of subscribers with a pending deadline. */
+    [[nodiscard]] qsizetype size() const;
+
+private:
+    struct HeapEntry {
+        qint64 deadline; // msecs since epoch, including slack
+        QObject *subscriber;
+
+        [[nodiscard]] constexpr bool operator>(const HeapEntry &other) const
+        {
+            return deadline > other.deadline;
+        }
+    };
+    // min-heap, entries whose subscriber has been rescheduled or cancelled are removed lazily
+    std::vector<HeapEntry> m_heap;
+
+    struct Subscription {
+        qint64 deadline;
+        std::function<void()> callback;
+        QMetaObject::Connection destroyedConnection;
+    };
+    QHash<QObject *, Subscription> m_subscriptions;
+
+    void processExpired();
+    void scheduleTimer();
+    void remove(QHash<QObject *, Subscription>::iterator it);
+
+    QChronoTimer m_timer;
+};
+
+#endif // DEADLINESCHEDULER_H
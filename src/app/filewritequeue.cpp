@@ -0,0 +1,146 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "filewritequeue.h"
+#include "logging.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <chrono>
+#include <utility>
+
+using namespace std::chrono_literals;
+
+// repeated writes to the same file within this are coalesced
+constexpr auto CoalescingWindow = 500ms;
+
+namespace
+{
+struct PendingWrite {
+    QByteArray data;
+    QDateTime modificationTime;
+    bool remove = false;
+};
+
+struct WriteQueue {
+    WriteQueue()
+    {
+        // single thread, so writes are done in the order they were scheduled in
+        pool.setMaxThreadCount(1);
+        qAddPostRoutine(FileWriteQueue::flush);
+    }
+
+    QMutex mutex;
+    QHash<QString, PendingWrite> pending;
+    bool flushScheduled = false;
+    QThreadPool pool;
+};
+}
+
+[[nodiscard]] static WriteQueue &writeQueue()
+{
+    static WriteQueue q;
+    return q;
+}
+
+static void writeFile(const QString &fileName, const PendingWrite &write)
+{
+    if (write.remove) {
+        QFile::remove(fileName);
+        return;
+    }
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSaveFile f(fileName);
+    if (!f.open(QFile::WriteOnly)) {
+        qCWarning(Log) << "Failed to open file for writing:" << f.fileName() << f.errorString();
+        return;
+    }
+    f.write(write.data);
+    if (!f.commit()) {
+        qCWarning(Log) << "Failed to write file:" << f.fileName() << f.errorString();
+        return;
+    }
+
+    if (write.modificationTime.isValid()) {
+        // mtime changes need to be done without content changes to take effect
+        QFile mtimeFile(fileName);
+        if (mtimeFile.open(QFile::WriteOnly | QFile::Append)) {
+            mtimeFile.setFileTime(write.modificationTime, QFile::FileModificationTime);
+        }
+    }
+}
+
+static void writeFiles(const QHash<QString, PendingWrite> &writes)
+{
+    for (auto it = writes.begin(); it != writes.end(); ++it) {
+        writeFile(it.key(), it.value());
+    }
+}
+
+static void enqueue(const QString &fileName, PendingWrite &&write)
+{
+    auto &q = writeQueue();
+    QMutexLocker locker(&q.mutex);
+    q.pending.insert(fileName, std::move(write));
+    if (q.flushScheduled) {
+        return;
+    }
+    if (!QCoreApplication::instance()) {
+        locker.unlock();
+        FileWriteQueue::flush();
+        return;
+    }
+
+    q.flushScheduled = true;
+    QTimer::singleShot(CoalescingWindow, QCoreApplication::instance(), [] {
+        auto &q = writeQueue();
+        QMutexLocker locker(&q.mutex);
+        q.flushScheduled = false;
+        auto writes = std::exchange(q.pending, {});
+        locker.unlock();
+        if (!writes.isEmpty()) {
+            q.pool.start([writes = std::move(writes)]() {
+                writeFiles(writes);
+            });
+        }
+    });
+}
+
+void FileWriteQueue::write(const QString &fileName, const QByteArray &data, const QDateTime &modificationTime)
+{
+    enqueue(fileName, {.data = data, .modificationTime = modificationTime});
+}
+
+void FileWriteQueue::write(const QString &fileName, const QByteArray &data)
+{
+    enqueue(fileName, {.data = data});
+}
+
+void FileWriteQueue::remove(const QString &fileName)
+{
+    enqueue(fileName, {.remove = true});
+}
+
+void FileWriteQueue::flush()
+{
+    auto &q = writeQueue();
+    // writes already handed to the worker thread go first
+    q.pool.waitForDone();
+
+    QMutexLocker locker(&q.mutex);
+    const auto writes = std::exchange(q.pending, {});
+    locker.unlock();
+    writeFiles(writes);
+}
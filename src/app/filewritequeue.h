@@ -0,0 +1,36 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef FILEWRITEQUEUE_H
+#define FILEWRITEQUEUE_H
+
+class QByteArray;
+class QDateTime;
+class QString;
+
+/** Write-behind queue for persisting small data files.
+ *  Writes are collected for a short time window, with repeated writes to the same
+ *  file being coalesced, and are then done on a worker thread. Files are replaced
+ *  atomically, so an interrupted write never leaves a truncated file behind.
+ *
+ *  Anything reading files written via this needs to call flush() first.
+ *  Pending writes are also flushed when the application shuts down.
+ */
+namespace FileWriteQueue
+{
+/** Schedule writing @p data to @p fileName.
+ *  Missing parent directories are created.
+ *  @param modificationTime If valid, the file modification time is set to this.
+ */
+void write(const QString &fileName, const QByteArray &data, const QDateTime &modificationTime);
+void write(const QString &fileName, const QByteArray &data);
+/** Schedule removing @p fileName. */
+void remove(const QString &fileName);
+
+/** Synchronously write all pending changes. */
+void flush();
+}
+
+#endif // FILEWRITEQUEUE_H
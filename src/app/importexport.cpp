@@ -209,10 +209,11 @@ void Exporter::exportLiveData()
 
 void Exporter::exportLiveDataForBatch(const QString &batchId)
 {
-    const auto ld = LiveData::load(batchId);
+    auto ld = LiveData::load(batchId);
     if (ld.isEmpty()) {
         return;
     }
+    ld.trip = ld.tripWithPath();
 
     m_file->addCustomData(BUNDLE_LIVE_DATA_DOMAIN, batchId, QJsonDocument(LiveData::toJson(ld)).toJson());
 }
@@ -281,8 +282,15 @@ int Importer::formatVersion() const
 qsizetype Importer::importReservations(ReservationManager *resMgr)
 {
     const auto resIds = m_file->reservations();
+    QList<QVariant> resData;
+    resData.reserve(resIds.size());
     for (const auto &resId : resIds) {
-        m_resIdMap.insert(resId, resMgr->addReservation(m_file->reservation(resId), resId));
+        resData.push_back(m_file->reservation(resId));
+    }
+
+    const auto newResIds = resMgr->addReservations(resData, resIds);
+    for (qsizetype i = 0; i < resIds.size(); ++i) {
+        m_resIdMap.insert(resIds.at(i), newResIds.at(i));
     }
     return resIds.size();
 }
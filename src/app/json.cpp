@@ -6,6 +6,7 @@
 
 #include "json.h"
 #include "logging.h"
+#include "timezonecache.h"
 
 #include <QColor>
 #include <QDateTime>
@@ -129,7 +130,7 @@ static QVariant variantFromJson(const QJsonValue &v, int mt)
                 return {};
             }
             auto dt = QDateTime::fromString(valueIt.value().toString(), Qt::ISODate);
-            dt.setTimeZone(QTimeZone(dtObj.value(QLatin1StringView("timezone")).toString().toUtf8()));
+            dt.setTimeZone(TimeZoneCache::timeZone(dtObj.value(QLatin1StringView("timezone")).toString().toUtf8()));
             return dt;
         }
         return QDateTime::fromString(v.toString(), Qt::ISODate);
@@ -6,17 +6,96 @@
 
 #include "livedata.h"
 
+#include "filewritequeue.h"
 #include "jsonio.h"
 #include "logging.h"
+#include "recordstore.h"
 
+#include <KPublicTransport/Path>
+
+#include <QCryptographicHash>
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
 #include <QJsonObject>
 #include <QStandardPaths>
 
+#include <algorithm>
+
 using namespace Qt::Literals::StringLiterals;
 
+[[nodiscard]] static RecordStore &liveDataStore()
+{
+    static RecordStore s_store(LiveData::storePath());
+    return s_store;
+}
+
+// live data store records: the trip in one record, which only changes when the trip
+// content changes, and timestamp and indexes in a small separate record that changes on every update
+constexpr inline auto MetaDataKeyPrefix = "meta:"_L1;
+
+[[nodiscard]] static QString metaDataKey(const QString &resId)
+{
+    return MetaDataKeyPrefix + resId;
+}
+
+// path geometry is by far the largest part of the trip data, but only needed for maps and exports
+// so it's stored separately, keyed by the identity of the trip rather than the batch, that way
+// trip updates don't rewrite it and batches on the same trip share it
+constexpr inline auto PathKeyPrefix = "path:"_L1;
+
+[[nodiscard]] static QString pathKey(const KPublicTransport::JourneySection &trip)
+{
+    const auto locationKey = [](const KPublicTransport::Location &loc) {
+        return loc.name() + '@'_L1 + QString::number(loc.latitude()) + ','_L1 + QString::number(loc.longitude());
+    };
+    const auto key = QString::number(trip.route().line().mode()) + '|'_L1 + trip.route().line().name() + '|'_L1
+        + trip.scheduledDepartureTime().toString(Qt::ISODate) + '|'_L1 + locationKey(trip.from()) + '|'_L1 + locationKey(trip.to());
+    return PathKeyPrefix + QString::fromLatin1(QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+[[nodiscard]] static QString readPathKey(RecordStore &store, const QString &metaKey)
+{
+    return JsonIO::read(store.read(metaKey)).toObject().value("pathKey"_L1).toString();
+}
+
+// number of trips referencing each stored path, built once from the meta data records
+// needs to be obtained before changing any meta data record
+[[nodiscard]] static QHash<QString, int> &pathReferences()
+{
+    static QHash<QString, int> s_refs = [] {
+        QHash<QString, int> refs;
+        auto &store = liveDataStore();
+        for (const auto &key : store.keys()) {
+            if (!key.startsWith(MetaDataKeyPrefix)) {
+                continue;
+            }
+            if (const auto refKey = readPathKey(store, key); !refKey.isEmpty()) {
+                ++refs[refKey];
+            }
+        }
+        return refs;
+    }();
+    return s_refs;
+}
+
+// remove path data no longer referenced by any trip
+static void releasePath(RecordStore &store, QHash<QString, int> &refs, const QString &key)
+{
+    if (key.isEmpty()) {
+        return;
+    }
+    if (const auto it = refs.find(key); it != refs.end()) {
+        if (--(*it) > 0) {
+            return;
+        }
+        refs.erase(it);
+    }
+    if (store.contains(key)) {
+        store.remove(key);
+    }
+}
+
 bool LiveData::isEmpty() const
 {
     return trip.from().isEmpty() && trip.to().isEmpty();
@@ -38,6 +117,63 @@ KPublicTransport::Stopover LiveData::arrival() const
 }
 
 LiveData LiveData::load(const QString &resId)
+{
+    auto &store = liveDataStore();
+    const auto tripData = store.read(resId);
+    LiveData ld;
+    if (tripData.isNull()) {
+        return ld;
+    }
+
+    ld.trip = KPublicTransport::JourneySection::fromJson(JsonIO::read(tripData).toObject());
+    const auto metaObj = JsonIO::read(store.read(metaDataKey(resId))).toObject();
+    if (const auto it = metaObj.find("timestamp"_L1); it != metaObj.end()) {
+        ld.journeyTimestamp = QDateTime::fromMSecsSinceEpoch((*it).toInteger());
+    }
+    ld.departureIndex = metaObj.value("departureIndex"_L1).toInteger(-1);
+    ld.arrivalIndex = metaObj.value("arrivalIndex"_L1).toInteger(-1);
+    ld.m_pathKey = metaObj.value("pathKey"_L1).toString();
+
+    ld.recoverIndexes();
+    return ld;
+}
+
+QString LiveData::storedPathKey() const
+{
+    return m_pathKey.isEmpty() ? pathKey(trip) : m_pathKey;
+}
+
+KPublicTransport::Path LiveData::loadPath() const
+{
+    if (!trip.path().isEmpty()) {
+        return trip.path(); // not stored yet
+    }
+    const auto pathData = liveDataStore().read(storedPathKey());
+    if (pathData.isEmpty()) {
+        return {};
+    }
+    return KPublicTransport::Path::fromJson(JsonIO::read(pathData).toObject());
+}
+
+bool LiveData::hasPath() const
+{
+    return !trip.path().isEmpty() || liveDataStore().contains(storedPathKey());
+}
+
+KPublicTransport::JourneySection LiveData::tripWithPath() const
+{
+    auto t = trip;
+    t.setPath(loadPath());
+    return t;
+}
+
+KPublicTransport::JourneySection LiveData::journeyWithPath() const
+{
+    const auto t = tripWithPath();
+    return (departureIndex < 0 || arrivalIndex < 0) ? t : t.subsection(departureIndex, arrivalIndex);
+}
+
+LiveData LiveData::loadLegacy(const QString &resId)
 {
     LiveData ld;
 
@@ -60,59 +196,100 @@ LiveData LiveData::load(const QString &resId)
     return ld;
 }
 
-void LiveData::store(const QString &resId) const
+void LiveData::store(const QString &resId)
 {
-    const auto path = basePath();
-    QDir().mkpath(path);
-
-    const QString fileName = path + resId + ".json"_L1;
-    const QString metaFileName = path + resId + ".meta"_L1;
-
+    const auto path = trip.path();
+    trip.setPath({});
     const auto obj = KPublicTransport::JourneySection::toJson(trip);
     if (obj.isEmpty()) {
-        QFile::remove(fileName);
-        QFile::remove(metaFileName);
-    } else {
-        QFile file(fileName);
-        if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
-            qCWarning(Log) << "Failed to open trip data file:" << file.fileName() << file.errorString();
-            return;
+        remove(resId);
+        return;
+    }
+
+    auto &store = liveDataStore();
+    auto &refs = pathReferences();
+    const auto newPathKey = pathKey(trip);
+    if (!path.isEmpty()) {
+        const auto pathData = JsonIO::write(KPublicTransport::Path::toJson(path));
+        if (store.valueSize(newPathKey) != pathData.size() || store.read(newPathKey) != pathData) {
+            store.write(newPathKey, pathData);
         }
-        file.write(JsonIO::write(obj));
-        file.close();
+    }
+
+    // most updates don't change anything but the timestamp, so only rewrite the trip if it actually changed
+    const auto tripData = JsonIO::write(obj);
+    if (store.valueSize(resId) != tripData.size() || store.read(resId) != tripData) {
+        store.write(resId, tripData);
+    }
 
-        // mtime changes need to be done without content changes to take effect
-        file.open(QFile::WriteOnly | QFile::Append);
-        file.setFileTime(journeyTimestamp, QFile::FileModificationTime);
-        file.close();
+    // updates without path data keep referring to the previously stored path, even if
+    // the trip identity changed slightly, unless there's one for the new identity already
+    const auto metaKey = metaDataKey(resId);
+    const auto oldPathKey = readPathKey(store, metaKey);
+    m_pathKey = (path.isEmpty() && !store.contains(newPathKey)) ? oldPathKey : newPathKey;
 
-        QFile metaFile(metaFileName);
-        if (!metaFile.open(QFile::WriteOnly | QFile::Truncate)) {
-            qCWarning(Log) << "Failed to open public trip metadata file:" << metaFile.fileName() << metaFile.errorString();
-            return;
+    QJsonObject metaObj{
+        {"departureIndex"_L1, departureIndex},
+        {"arrivalIndex"_L1, arrivalIndex},
+    };
+    if (journeyTimestamp.isValid()) {
+        metaObj.insert("timestamp"_L1, journeyTimestamp.toMSecsSinceEpoch());
+    }
+    if (!m_pathKey.isEmpty()) {
+        metaObj.insert("pathKey"_L1, m_pathKey);
+    }
+    store.write(metaKey, JsonIO::write(metaObj));
+
+    if (oldPathKey != m_pathKey) {
+        if (!m_pathKey.isEmpty()) {
+            ++refs[m_pathKey];
         }
-        QJsonObject metaObj{
-            {"departureIndex"_L1, departureIndex},
-            {"arrivalIndex"_L1, arrivalIndex}
-        };
-        metaFile.write(JsonIO::write(metaObj));
+        releasePath(store, refs, oldPathKey);
     }
 }
 
 void LiveData::remove(const QString &resId)
 {
-    QFile::remove(basePath() + resId + ".json"_L1);
-    QFile::remove(basePath() + resId + ".meta"_L1);
+    auto &store = liveDataStore();
+    auto &refs = pathReferences();
+    const auto metaKey = metaDataKey(resId);
+    const auto oldPathKey = readPathKey(store, metaKey);
+    store.remove(resId);
+    store.remove(metaKey);
+    releasePath(store, refs, oldPathKey);
 }
 
 std::vector<QString> LiveData::listAll()
 {
-    std::vector<QString> ids;
+    auto ids = liveDataStore().keys();
+    std::erase_if(ids, [](const auto &key) {
+        return key.startsWith(MetaDataKeyPrefix) || key.startsWith(PathKeyPrefix);
+    });
+    return ids;
+}
+
+int LiveData::importLegacyFiles()
+{
+    int count = 0;
     for (QDirIterator it(basePath(), {"*.json"_L1}, QDir::Files); it.hasNext();) {
         it.next();
-        ids.push_back(it.fileInfo().baseName());
+        if (!it.fileInfo().isReadable()) {
+            qCWarning(Log) << "Failed to read live data file:" << it.filePath();
+            continue;
+        }
+        const auto resId = it.fileInfo().baseName();
+        // anything already in the store is from after a previous partial import, and thus newer
+        if (!liveDataStore().contains(resId)) {
+            auto ld = loadLegacy(resId);
+            if (!ld.isEmpty()) {
+                ld.store(resId);
+            }
+        }
+        QFile::remove(it.filePath());
+        QFile::remove(basePath() + resId + ".meta"_L1);
+        ++count;
     }
-    return ids;
+    return count;
 }
 
 QJsonObject LiveData::toJson(const LiveData &ld)
@@ -159,8 +336,16 @@ QString LiveData::basePath()
     return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/livedata/"_L1;
 }
 
+QString LiveData::storePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/livedata.log"_L1;
+}
+
 void LiveData::clearStorage()
 {
+    liveDataStore().clear();
+    pathReferences().clear();
+    FileWriteQueue::flush();
     QDir(basePath()).removeRecursively();
 }
 
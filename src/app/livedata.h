@@ -8,6 +8,7 @@
 #define LIVEDATA_H
 
 #include <KPublicTransport/Journey>
+#include <KPublicTransport/Path>
 #include <KPublicTransport/Stopover>
 
 #include <QDateTime>
@@ -30,10 +31,24 @@ public:
     [[nodiscard]] KPublicTransport::Stopover departure() const;
     [[nodiscard]] KPublicTransport::Stopover arrival() const;
 
+    /** Path geometry of @p trip.
+     *  Loaded and stored trips don't contain their path, this reads it from storage.
+     *  Only use this where the path is actually needed, such as for maps or exports.
+     */
+    [[nodiscard]] KPublicTransport::Path loadPath() const;
+    /** Checks whether path geometry is available for @p trip, without loading it. */
+    [[nodiscard]] bool hasPath() const;
+    /** Same as trip/journey(), but including the path geometry. */
+    [[nodiscard]] KPublicTransport::JourneySection tripWithPath() const;
+    [[nodiscard]] KPublicTransport::JourneySection journeyWithPath() const;
+
     /** Load live data for reservation batch with id @resId. */
     [[nodiscard]] static LiveData load(const QString &resId);
-    /** Store this data for reservation batch @p resId. */
-    void store(const QString &resId) const;
+    /** Store this data for reservation batch @p resId.
+     *  The path geometry is moved out of @p trip into separate storage.
+     *  @see loadPath()
+     */
+    void store(const QString &resId);
     /** Removes all stored data for a given id. */
     static void remove(const QString &resId);
 
@@ -47,10 +62,20 @@ public:
     /** Deserialize from JSON. */
     [[nodiscard]] static LiveData fromJson(const QJsonObject &obj);
 
-    /** Base path for live data storage.
+    /** Storage locations of live data.
+     *  basePath() is the legacy one file pair per batch storage, storePath() the
+     *  single file record store replacing that.
      *  Do not use directly, only exposed for data migration.
      */
     [[nodiscard]] static QString basePath();
+    [[nodiscard]] static QString storePath();
+
+    /** Import live data stored in the legacy one file pair per batch layout in basePath()
+     *  into the live data store.
+     *  Imported files are removed, files that failed to import are left in place.
+     *  @returns The number of imported files.
+     */
+    static int importLegacyFiles();
 
     /** Clears all stored live data.
      *  @internal For unit tests only.
@@ -58,8 +83,15 @@ public:
     static void clearStorage();
 
 private:
+    /** Load from legacy storage, only used for importing. */
+    [[nodiscard]] static LiveData loadLegacy(const QString &resId);
     /** Populate departure/arrival indexes for legacy data. */
     void recoverIndexes();
+    /** Storage key of the path geometry of @p trip. */
+    [[nodiscard]] QString storedPathKey() const;
+
+    // key of the path record this was stored with, can differ from the one matching @p trip
+    QString m_pathKey;
 };
 
 #endif // LIVEDATA_H
@@ -12,6 +12,7 @@
 #include "publictransportmatcher.h"
 #include "reservationhelper.h"
 #include "reservationmanager.h"
+#include "tripquerydispatcher.h"
 
 #include <KItinerary/BusTrip>
 #include <KItinerary/Flight>
@@ -47,10 +48,12 @@ using namespace Qt::Literals;
 using namespace KItinerary;
 
 static constexpr const int POLL_COOLDOWN_ON_ERROR = 30; // seconds
+static constexpr const int MAX_POLL_COOLDOWN_ON_ERROR = 30 * 60; // seconds
 
 LiveDataManager::LiveDataManager(QObject *parent)
     : QObject(parent)
     , m_ptMgr(new KPublicTransport::Manager(this))
+    , m_tripQueries(new TripQueryDispatcher(m_ptMgr, this))
     , m_onboardStatus(new KPublicTransport::OnboardStatus(this))
 {
     QSettings settings;
@@ -69,6 +72,17 @@ LiveDataManager::LiveDataManager(QObject *parent)
     m_pollTimer.setSingleShot(true);
     connect(&m_pollTimer, &QChronoTimer::timeout, this, &LiveDataManager::poll);
 
+    connect(m_tripQueries, &TripQueryDispatcher::tripQueryFinished, this, [this](const QString &batchId, const KPublicTransport::JourneySection &jny) {
+        if (jny.mode() == KPublicTransport::JourneySection::PublicTransport) {
+            m_queryFailures.remove(batchId);
+            applyJourney(batchId, jny);
+        } else {
+            tripQueryFailed(batchId);
+        }
+    });
+    // record this is a failed lookup so we don't try again
+    connect(m_tripQueries, &TripQueryDispatcher::tripQueryFailed, this, &LiveDataManager::tripQueryFailed);
+
     connect(m_onboardStatus, &KPublicTransport::OnboardStatus::journeyChanged, [this]() {
         if (!m_onboardStatus->hasJourney()) {
             return;
@@ -78,7 +92,8 @@ LiveDataManager::LiveDataManager(QObject *parent)
         if (journey.sections().empty()) {
             return;
         }
-        for (const auto &resId : m_reservations) {
+        const auto batchIds = m_reservations.keys();
+        for (const auto &resId : batchIds) {
             auto res = m_resMgr->reservation(resId);
             if (!hasDeparted(resId, res) || hasArrived(resId, res)) {
                 continue;
@@ -116,7 +131,7 @@ void LiveDataManager::setReservationManager(ReservationManager *resMgr)
         if (!isRelevant(batchId)) {
             continue;
         }
-        m_reservations.push_back(batchId);
+        schedulePoll(batchId);
     }
 
     m_pollTimer.setInterval(nextPollTime());
@@ -168,6 +183,21 @@ KPublicTransport::JourneySection LiveDataManager::trip(const QString &resId) con
     return data(resId).trip;
 }
 
+KPublicTransport::JourneySection LiveDataManager::journeyWithPath(const QString &resId) const
+{
+    return data(resId).journeyWithPath();
+}
+
+KPublicTransport::JourneySection LiveDataManager::tripWithPath(const QString &resId) const
+{
+    return data(resId).tripWithPath();
+}
+
+bool LiveDataManager::hasPath(const QString &resId) const
+{
+    return data(resId).hasPath();
+}
+
 qsizetype LiveDataManager::tripDepartureIndex(const QString &resId) const
 {
     return data(resId).departureIndex;
@@ -186,6 +216,7 @@ void LiveDataManager::setJourney(const QString &resId, const KPublicTransport::J
     ld.arrivalIndex = (qsizetype)journey.intermediateStops().size() + 1;
     ld.journeyTimestamp = now();
     ld.store(resId);
+    reschedulePoll(resId);
 
     Q_EMIT journeyUpdated(resId);
 }
@@ -200,6 +231,7 @@ void LiveDataManager::checkForUpdates(const QStringList &batchIds)
     clearArrived();
     for (const auto &batchId : batchIds) {
         pollBatchForUpdates(batchId, true);
+        reschedulePoll(batchId);
     }
 }
 
@@ -231,19 +263,7 @@ void LiveDataManager::checkReservation(const QVariant &res, const QString &resId
         PublicTransport::selectBackends(req, m_ptMgr, res);
     }
     if (canSelectBackend(jny.from()) || canSelectBackend(jny.to()) || !req.backendIds().isEmpty() || jny.hasIdentifiers()) {
-        auto reply = m_ptMgr->queryTrip(req);
-        connect(reply, &Reply::finished, this, [this, resId, reply]() {
-            reply->deleteLater();
-            if (reply->error() == Reply::NoError) {
-                auto jny = reply->trip();
-                if (jny.mode() == JourneySection::PublicTransport) {
-                    applyJourney(resId, jny);
-                    return;
-                }
-            }
-            // record this is a failed lookup so we don't try again
-            tripQueryFailed(resId);
-        });
+        m_tripQueries->query(resId, req);
         m_lastPollAttempt.insert(resId, now());
     }
 }
@@ -251,6 +271,8 @@ void LiveDataManager::checkReservation(const QVariant &res, const QString &resId
 void LiveDataManager::tripQueryFailed(const QString &resId)
 {
     data(resId).journeyTimestamp = now();
+    ++m_queryFailures[resId];
+    reschedulePoll(resId);
 }
 
 static KPublicTransport::Stopover applyLayoutData(const KPublicTransport::Stopover &stop, const KPublicTransport::Stopover &layout)
@@ -318,9 +340,7 @@ static void applyMissingJourneyData(KPublicTransport::JourneySection &journey, c
     applyMissingStopoverData(s, oldJny.arrival());
     journey.setArrival(s);
 
-    if (journey.path().isEmpty()) {
-        journey.setPath(oldJny.path());
-    }
+    // path geometry isn't carried over here, LiveData stores that separately by trip identity
     if (journey.notes().empty()) {
         journey.setNotes(oldJny.notes());
     }
@@ -410,6 +430,7 @@ void LiveDataManager::applyJourney(const QString &resId, const KPublicTransport:
     ld.trip.applyMetaData(true); // download logo assets if needed
     ld.journeyTimestamp = now();
     ld.store(resId);
+    reschedulePoll(resId);
 
     // update reservation with live data
     std::vector<ReservationManager::ReservationChange> resUpdates;
@@ -421,7 +442,7 @@ void LiveDataManager::applyJourney(const QString &resId, const KPublicTransport:
         }
     }
     qCDebug(Log) << "submitting" << resUpdates.size() << "reservation changes";
-    m_resMgr->updateBatch(resUpdates);
+    m_resMgr->updateBatch(resUpdates, true);
 
     // emit update signals
     Q_EMIT journeyUpdated(resId);
@@ -557,6 +578,7 @@ void LiveDataManager::importData(const QString &resId, LiveData &&data)
 {
     // we don't need to store data, Importer already does that
     m_data[resId] = std::move(data);
+    reschedulePoll(resId);
     Q_EMIT journeyUpdated(resId);
 }
 
@@ -598,21 +620,14 @@ void LiveDataManager::batchAdded(const QString &resId)
         return;
     }
 
-    m_reservations.push_back(resId);
+    schedulePoll(resId);
     m_pollTimer.setInterval(nextPollTime());
 }
 
 void LiveDataManager::batchChanged(const QString &resId)
 {
-    const auto it = std::find(m_reservations.begin(), m_reservations.end(), resId);
     const auto relevant = isRelevant(resId);
 
-    if (it == m_reservations.end() && relevant) {
-        m_reservations.push_back(resId);
-    } else if (it != m_reservations.end() && !relevant) {
-        m_reservations.erase(it);
-    }
-
     // check if existing updates still apply, and remove them otherwise!
     const auto res = m_resMgr->reservation(resId);
     const auto dataIt = m_data.find(resId);
@@ -638,36 +653,66 @@ void LiveDataManager::batchChanged(const QString &resId)
         }
     }
 
+    // departure/arrival times or live data might have changed
+    if (relevant) {
+        schedulePoll(resId);
+    } else {
+        m_reservations.remove(resId);
+        prunePollQueue();
+    }
     m_pollTimer.setInterval(nextPollTime());
 }
 
 void LiveDataManager::batchRenamed(const QString &oldBatchId, const QString &newBatchId)
 {
-    const auto it = std::find(m_reservations.begin(), m_reservations.end(), oldBatchId);
-    if (it != m_reservations.end()) {
-        *it = newBatchId;
+    if (m_reservations.remove(oldBatchId)) {
+        schedulePoll(newBatchId);
     }
 }
 
 void LiveDataManager::batchRemoved(const QString &resId)
 {
-    const auto it = std::find(m_reservations.begin(), m_reservations.end(), resId);
-    if (it != m_reservations.end()) {
-        m_reservations.erase(it);
+    if (m_reservations.remove(resId)) {
+        prunePollQueue();
     }
 
     cancelNotification(resId);
     LiveData::remove(resId);
     m_data.remove(resId);
     m_lastPollAttempt.remove(resId);
+    m_queryFailures.remove(resId);
 }
 
 void LiveDataManager::poll()
 {
     qCDebug(Log);
-    pollForUpdates(false);
 
-    m_pollTimer.setInterval(std::max(nextPollTime(), std::chrono::seconds(60))); // we pool everything that happens within a minute here
+    // only look at batches that are due, we pool everything that happens within a minute here
+    const auto threshold = now().addSecs(60).toMSecsSinceEpoch();
+    QStringList dueBatchIds;
+    while (!m_pollQueue.empty() && m_pollQueue.front().deadline <= threshold) {
+        std::pop_heap(m_pollQueue.begin(), m_pollQueue.end(), std::greater<>());
+        const auto entry = std::move(m_pollQueue.back());
+        m_pollQueue.pop_back();
+        const auto it = m_reservations.find(entry.batchId);
+        if (it == m_reservations.end() || (*it) != entry.deadline) {
+            continue;
+        }
+        (*it) = -1; // outdates duplicate entries, rescheduled below
+        dueBatchIds.push_back(entry.batchId);
+    }
+
+    for (const auto &batchId : dueBatchIds) {
+        if (clearArrived(batchId)) {
+            continue;
+        }
+        // we might have woken up only because the poll interval changed, this takes care of that
+        pollBatchForUpdates(batchId, false);
+        schedulePoll(batchId);
+    }
+    prunePollQueue();
+
+    m_pollTimer.setInterval(std::max(nextPollTime(), std::chrono::seconds(60)));
     m_pollTimer.start();
 }
 
@@ -675,8 +720,10 @@ void LiveDataManager::pollForUpdates(bool force)
 {
     clearArrived();
 
-    for (const auto &batchId : m_reservations) {
+    const auto batchIds = m_reservations.keys();
+    for (const auto &batchId : batchIds) {
         pollBatchForUpdates(batchId, force);
+        schedulePoll(batchId);
     }
 }
 
@@ -715,27 +762,35 @@ void LiveDataManager::pollBatchForUpdates(const QString &batchId, bool force)
 
 void LiveDataManager::clearArrived()
 {
-    for (auto it = m_reservations.begin(); it != m_reservations.end();) {
-        const auto batchId = *it;
-        const auto res = m_resMgr->reservation(*it);
+    const auto batchIds = m_reservations.keys();
+    for (const auto &batchId : batchIds) {
+        clearArrived(batchId);
+    }
+    prunePollQueue();
+}
 
-        // clean up obsolete stuff
-        if (hasArrived(*it, res)) {
-            cancelNotification(*it);
-            it = m_reservations.erase(it);
-            m_lastPollAttempt.remove(batchId);
-        } else {
-            ++it;
-        }
+bool LiveDataManager::clearArrived(const QString &batchId)
+{
+    const auto res = m_resMgr->reservation(batchId);
+    if (!hasArrived(batchId, res)) {
+        return false;
     }
+
+    // clean up obsolete stuff
+    cancelNotification(batchId);
+    m_reservations.remove(batchId);
+    m_lastPollAttempt.remove(batchId);
+    m_queryFailures.remove(batchId);
+    return true;
 }
 
 std::chrono::seconds LiveDataManager::nextPollTime() const
 {
-    auto t = std::chrono::seconds(std::numeric_limits<int>::max());
-    for (const auto &resId : m_reservations) {
-        t = std::min(t, nextPollTimeForReservation(resId));
+    // prunePollQueue() ensures the top entry is valid
+    if (m_pollQueue.empty()) {
+        return std::chrono::seconds(std::numeric_limits<int>::max());
     }
+    const auto t = std::chrono::seconds(std::clamp<qint64>((m_pollQueue.front().deadline - now().toMSecsSinceEpoch()) / 1000, 0, std::numeric_limits<int>::max()));
     qCDebug(Log) << "next auto-update in" << t << "secs";
     return t;
 }
@@ -780,6 +835,74 @@ std::chrono::seconds LiveDataManager::nextPollTimeForReservation(const QString &
     return std::max(std::chrono::seconds(it->pollInterval - lastPollDist), pollCooldown(resId)); // we need msecs
 }
 
+QDateTime LiveDataManager::nextPollCheckTime(const QString &batchId) const
+{
+    const auto res = m_resMgr->reservation(batchId);
+    const auto now = this->now();
+    const auto depTime = departureTime(batchId, res);
+    const auto arrTime = arrivalTime(batchId, res);
+
+    // next poll according to the current poll interval
+    auto dt = now.addSecs(std::min<qint64>(nextPollTimeForReservation(batchId).count(), MAX_POLL_INTERVAL));
+
+    // the poll interval depends on the distance to departure or arrival, so we need to look
+    // again once that crosses into the next row of the poll interval table
+    const auto target = now < depTime ? depTime : arrTime;
+    if (target.isValid()) {
+        dt = std::min(dt, target);
+        const auto dist = now.secsTo(target);
+        const auto it = std::lower_bound(std::begin(pollIntervalTable), std::end(pollIntervalTable), dist, [](const auto &lhs, const auto rhs) {
+            return lhs.distance < rhs;
+        });
+        if (it != std::begin(pollIntervalTable) && it != std::end(pollIntervalTable)) {
+            dt = std::min(dt, target.addSecs(-std::prev(it)->distance));
+        }
+    }
+    // drop it after arrival
+    if (arrTime.isValid()) {
+        dt = std::min(dt, arrTime.addSecs(1));
+    }
+
+    return std::max(dt, now);
+}
+
+void LiveDataManager::schedulePoll(const QString &batchId)
+{
+    const auto deadline = nextPollCheckTime(batchId).toMSecsSinceEpoch();
+    auto it = m_reservations.find(batchId);
+    if (it != m_reservations.end() && (*it) == deadline) {
+        return;
+    }
+    m_reservations.insert(batchId, deadline);
+    m_pollQueue.push_back({deadline, batchId});
+    std::push_heap(m_pollQueue.begin(), m_pollQueue.end(), std::greater<>());
+    prunePollQueue();
+}
+
+void LiveDataManager::reschedulePoll(const QString &batchId)
+{
+    if (m_reservations.contains(batchId)) {
+        schedulePoll(batchId);
+    }
+}
+
+void LiveDataManager::prunePollQueue()
+{
+    const auto isOutdated = [this](const PollQueueEntry &entry) {
+        const auto it = m_reservations.constFind(entry.batchId);
+        return it == m_reservations.constEnd() || (*it) != entry.deadline;
+    };
+
+    if (m_pollQueue.size() > 2 * (std::size_t)m_reservations.size() + 16) {
+        std::erase_if(m_pollQueue, isOutdated);
+        std::make_heap(m_pollQueue.begin(), m_pollQueue.end(), std::greater<>());
+    }
+    while (!m_pollQueue.empty() && isOutdated(m_pollQueue.front())) {
+        std::pop_heap(m_pollQueue.begin(), m_pollQueue.end(), std::greater<>());
+        m_pollQueue.pop_back();
+    }
+}
+
 QDateTime LiveDataManager::lastPollTime(const QString &batchId, const QVariant &res) const
 {
     auto dt = data(batchId).journeyTimestamp;
@@ -809,7 +932,9 @@ std::chrono::seconds LiveDataManager::pollCooldown(const QString &resId) const
     if (!lastPollTime.isValid()) {
         return std::chrono::seconds(0);
     }
-    return std::chrono::seconds(std::clamp<int>(POLL_COOLDOWN_ON_ERROR - lastPollTime.secsTo(now()), 0, POLL_COOLDOWN_ON_ERROR));
+    // exponential backoff on repeated trip query failures
+    const auto cooldown = std::min(POLL_COOLDOWN_ON_ERROR << std::min(m_queryFailures.value(resId), 6), MAX_POLL_COOLDOWN_ON_ERROR);
+    return std::chrono::seconds(std::clamp<int>(cooldown - lastPollTime.secsTo(now()), 0, cooldown));
 }
 
 void LiveDataManager::pkPassUpdated(const QString &passId, const QStringList &changes)
@@ -819,16 +944,21 @@ void LiveDataManager::pkPassUpdated(const QString &passId, const QStringList &ch
     }
 
     QVariant passRes;
+    QString passBatchId;
 
     // Find relevant reservation for the given passId.
-    for (const QString &resId : std::as_const(m_reservations)) {
-        const auto res = m_resMgr->reservation(resId);
+    for (auto it = m_reservations.cbegin(); it != m_reservations.cend(); ++it) {
+        const auto res = m_resMgr->reservation(it.key());
         const auto resPassId = PkPassManager::passId(res);
         if (resPassId == passId) {
             passRes = res;
+            passBatchId = it.key();
             break;
         }
     }
+    if (!passBatchId.isEmpty()) {
+        reschedulePoll(passBatchId);
+    }
 
     QString text = changes.join(QLatin1Char('\n'));
     if (const auto title = ReservationHelper::label(passRes); !title.isEmpty()) {
@@ -29,6 +29,7 @@ class KNotification;
 
 class PkPassManager;
 class ReservationManager;
+class TripQueryDispatcher;
 
 /** Handles querying live data sources for delays, etc. */
 class LiveDataManager : public QObject
@@ -53,6 +54,14 @@ public:
     Q_INVOKABLE KPublicTransport::JourneySection journey(const QString &resId) const;
 
     [[nodiscard]] KPublicTransport::JourneySection trip(const QString &resId) const;
+    /** Same as journey()/trip(), but including path geometry.
+     *  The path is not kept in memory but loaded from storage on every call,
+     *  so only use this when actually needing the path.
+     */
+    [[nodiscard]] KPublicTransport::JourneySection journeyWithPath(const QString &resId) const;
+    [[nodiscard]] KPublicTransport::JourneySection tripWithPath(const QString &resId) const;
+    /** Checks whether path geometry is available for @p resId, without loading it. */
+    [[nodiscard]] bool hasPath(const QString &resId) const;
     [[nodiscard]] qsizetype tripDepartureIndex(const QString &resId) const;
     [[nodiscard]] qsizetype tripArrivalIndex(const QString &resId) const;
 
@@ -117,9 +126,22 @@ private:
     void pollForUpdates(bool force);
     void pollBatchForUpdates(const QString &batchId, bool force);
     void clearArrived();
+    /** Remove @p batchId from the set of batches we poll for, if it has arrived. */
+    bool clearArrived(const QString &batchId);
     std::chrono::seconds nextPollTime() const;
     std::chrono::seconds nextPollTimeForReservation(const QString &resId) const;
 
+    /** Next time we need to look at @p batchId again, either for polling or because
+     *  the poll interval for it changes.
+     */
+    [[nodiscard]] QDateTime nextPollCheckTime(const QString &batchId) const;
+    /** Add or update @p batchId in the poll queue. */
+    void schedulePoll(const QString &batchId);
+    /** Update @p batchId in the poll queue, if we poll for it at all. */
+    void reschedulePoll(const QString &batchId);
+    /** Drop outdated entries from the top of the poll queue. */
+    void prunePollQueue();
+
     /** Poll cooldown in msecs (ie. delay the next poll on errors). */
     std::chrono::seconds pollCooldown(const QString &redId) const;
 
@@ -132,9 +154,23 @@ private:
     ReservationManager *m_resMgr;
     PkPassManager *m_pkPassMgr;
     KPublicTransport::Manager *m_ptMgr;
-    std::vector<QString> m_reservations;
+    TripQueryDispatcher *m_tripQueries;
+    // batches we poll for, and the next time we need to check them (msecs since epoch)
+    QHash<QString, qint64> m_reservations;
+    struct PollQueueEntry {
+        qint64 deadline;
+        QString batchId;
+
+        [[nodiscard]] bool operator>(const PollQueueEntry &other) const
+        {
+            return deadline > other.deadline;
+        }
+    };
+    // min-heap by deadline, entries not matching m_reservations are outdated and skipped
+    std::vector<PollQueueEntry> m_pollQueue;
     mutable QHash<QString, LiveData> m_data;
     QHash<QString, QDateTime> m_lastPollAttempt; // poll cooldown on error
+    QHash<QString, int> m_queryFailures; // consecutive failed trip queries, for backing off
     QHash<QString, QPointer<KNotification>> m_notifications;
     bool m_showNotificationsOnLockScreen = false;
     bool m_downloadAssets = false;
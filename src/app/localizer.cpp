@@ -5,6 +5,7 @@
 */
 
 #include "localizer.h"
+#include "timezonecache.h"
 
 #include <KItinerary/JsonLdDocument>
 #include <KItinerary/Place>
@@ -127,7 +128,7 @@ QString Localizer::formatAddressWithContext(const QVariant &obj, const QVariant
 
 static bool needsTimeZone(const QDateTime &dt)
 {
-    if (dt.timeSpec() == Qt::TimeZone && dt.timeZone().abbreviation(dt) != QTimeZone::systemTimeZone().abbreviation(dt)) {
+    if (dt.timeSpec() == Qt::TimeZone && TimeZoneCache::abbreviation(dt.timeZone(), dt) != TimeZoneCache::abbreviation(QTimeZone::systemTimeZone(), dt)) {
         return true;
     } else if (dt.timeSpec() == Qt::OffsetFromUTC && dt.timeZone().offsetFromUtc(dt) != dt.offsetFromUtc()) {
         return true;
@@ -150,7 +151,7 @@ static QString tzAbbreviation(const QDateTime &dt)
                                                    QJniObject::fromString(QString::fromUtf8(tz.id())).object(),
                                                    dt.toMSecsSinceEpoch(),
                                                    KAndroidExtras::Locale::current().object(),
-                                                   tz.isDaylightTime(dt))
+                                                   TimeZoneCache::isDaylightTime(tz, dt))
                     .toString();
 
     if (!abbr.isEmpty()) {
@@ -158,7 +159,7 @@ static QString tzAbbreviation(const QDateTime &dt)
     }
 #endif
 
-    return tz.abbreviation(dt);
+    return TimeZoneCache::abbreviation(tz, dt);
 }
 
 QString Localizer::formatTime(const QVariant &obj, const QString &propertyName)
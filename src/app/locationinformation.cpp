@@ -5,6 +5,7 @@
 */
 
 #include "locationinformation.h"
+#include "timezonecache.h"
 
 #include <KCountry>
 #include <KLazyLocalizedString>
@@ -215,7 +216,7 @@ QDateTime LocationInformation::transitionTime() const
 void LocationInformation::setTimeZone(const QTimeZone &tz, const QDateTime &transitionTime)
 {
     if (m_timeZone.isValid() && tz.isValid()) {
-        m_timeZoneOffsetDelta = tz.offsetFromUtc(transitionTime) - m_timeZone.offsetFromUtc(transitionTime);
+        m_timeZoneOffsetDelta = TimeZoneCache::offsetFromUtc(tz, transitionTime) - TimeZoneCache::offsetFromUtc(m_timeZone, transitionTime);
     } else {
         m_timeZoneOffsetDelta = 0;
     }
@@ -224,17 +225,19 @@ void LocationInformation::setTimeZone(const QTimeZone &tz, const QDateTime &tran
 
     // check if this is a DST transition
     // the date logic is a special here as date/time math around DST changes behaves ... interestingly
-    if (m_timeZoneOffsetDelta == 0 && m_timeZone.isValid() && m_timeZone.hasDaylightTime() && m_timeZone.hasTransitions()) {
-        const auto nextTrans = m_timeZone.nextTransition(transitionTime.addSecs(-1));
+    if (m_timeZoneOffsetDelta == 0 && m_timeZone.isValid() && TimeZoneCache::hasDaylightTimeTransitions(m_timeZone)) {
+        const auto nextTrans = TimeZoneCache::nextTransition(m_timeZone, transitionTime.addSecs(-1));
         if (std::abs(nextTrans.atUtc.secsTo(transitionTime)) <= 3600) {
-            m_timeZoneOffsetDelta = m_timeZone.offsetFromUtc(transitionTime.addSecs(3601)) - m_timeZone.offsetFromUtc(transitionTime.addSecs(-3601));
+            m_timeZoneOffsetDelta = TimeZoneCache::offsetFromUtc(m_timeZone, transitionTime.addSecs(3601))
+                - TimeZoneCache::offsetFromUtc(m_timeZone, transitionTime.addSecs(-3601));
         }
     }
 }
 
 bool LocationInformation::hasRelevantTimeZoneChange(const LocationInformation &other) const
 {
-    return m_timeZone.isValid() && other.m_timeZone.isValid() && m_timeZone.offsetFromUtc(m_transitionTime) != other.m_timeZone.offsetFromUtc(m_transitionTime);
+    return m_timeZone.isValid() && other.m_timeZone.isValid()
+        && TimeZoneCache::offsetFromUtc(m_timeZone, m_transitionTime) != TimeZoneCache::offsetFromUtc(other.m_timeZone, m_transitionTime);
 }
 
 bool LocationInformation::timeZoneDiffers() const
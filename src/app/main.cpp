@@ -15,6 +15,7 @@
 #include "documentsmodel.h"
 #include "factory.h"
 #include "favoritelocationmodel.h"
+#include "filewritequeue.h"
 #include "genericpkpass.h"
 #include "healthcertificatemanager.h"
 #include "importcontroller.h"
@@ -37,6 +38,7 @@
 #include "reservationonlinepostprocessor.h"
 #include "scamwarningmanager.h"
 #include "settings.h"
+#include "startuptrace.h"
 #include "statisticsmodel.h"
 #include "statisticstimerangemodel.h"
 #include "tickettokenmodel.h"
@@ -185,6 +187,7 @@ Q_DECL_EXPORT
 #endif
 int main(int argc, char **argv)
 {
+    StartupTrace::mark("QApplication");
 #if HAVE_MAPLIBRE
     const QMapLibre::RendererType rendererType = QMapLibre::supportedRendererType();
     auto graphicsApi = static_cast<QSGRendererInterface::GraphicsApi>(rendererType);
@@ -209,6 +212,7 @@ int main(int argc, char **argv)
         QQuickStyle::setStyle(QStringLiteral("org.kde.desktop"));
     }
 #endif
+    StartupTrace::mark("About data and command line");
     QGuiApplication::setApplicationDisplayName(i18n("KDE Itinerary"));
     QGuiApplication::setWindowIcon(QIcon::fromTheme(QStringLiteral("org.kde.itinerary")));
 
@@ -271,8 +275,10 @@ int main(int argc, char **argv)
     KDBusService service(KDBusService::Unique);
 #endif
 
+    StartupTrace::mark("Migrator");
     Migrator::run();
 
+    StartupTrace::mark("PkPassManager");
     IntentHandler intentHandler;
 
     Settings settings;
@@ -282,20 +288,24 @@ int main(int argc, char **argv)
     pkPassMgr.setNetworkAccessManagerFactory(namFactory);
     PkPassManagerInstance::instance = &pkPassMgr;
 
+    StartupTrace::mark("ReservationManager");
     ReservationManager resMgr;
     ReservationManagerInstance::instance = &resMgr;
 
+    StartupTrace::mark("DocumentManager");
     DocumentManager docMgr;
     DocumentManagerInstance::instance = &docMgr;
 
     FavoriteLocationModel favLocModel;
     FavoriteLocationModelInstance::instance = &favLocModel;
 
+    StartupTrace::mark("TripGroupManager");
     TripGroupManager tripGroupMgr;
     tripGroupMgr.setReservationManager(&resMgr);
     TripGroupManagerInstance::instance = &tripGroupMgr;
     QObject::connect(&tripGroupMgr, &TripGroupManager::tripGroupRemoved, &ScamWarningManager::tripRemoved);
 
+    StartupTrace::mark("LiveDataManager");
     LiveDataManager liveDataMgr;
     liveDataMgr.setPkPassManager(&pkPassMgr);
     liveDataMgr.setReservationManager(&resMgr);
@@ -312,6 +322,7 @@ int main(int argc, char **argv)
     WeatherForecastManager::setAllowNetworkAccess(settings.weatherForecastEnabled());
     QObject::connect(&settings, &Settings::weatherForecastEnabledChanged, &WeatherForecastManager::setAllowNetworkAccess);
 
+    StartupTrace::mark("TransferManager");
     TransferManager transferManager;
     transferManager.setReservationManager(&resMgr);
     transferManager.setFavoriteLocationModel(&favLocModel);
@@ -324,8 +335,10 @@ int main(int argc, char **argv)
     QObject::connect(&settings, &Settings::wikimediaOnlineContentEnabledChanged, &transferManager, &TransferManager::setDownloadAssetsEnabled);
     TransferManagerInstance::instance = &transferManager;
 
+    StartupTrace::mark("Trip grouping");
     tripGroupMgr.setTransferManager(&transferManager);
 
+    StartupTrace::mark("Models");
     TripGroupModel tripGroupModel;
     tripGroupModel.setTripGroupManager(&tripGroupMgr);
     TripGroupModelInstance::instance = &tripGroupModel;
@@ -336,10 +349,12 @@ int main(int argc, char **argv)
     QObject::connect(&settings, &Settings::preloadMapDataChanged, &mapDownloadMgr, &MapDownloadManager::setAutomaticDownloadEnabled);
     MapDownloadManagerInstance::instance = &mapDownloadMgr;
 
+    StartupTrace::mark("PassManager");
     KItinerary::JsonLdDocument::registerType<GenericPkPass>();
     PassManager passMgr;
     PassManagerInstance::instance = &passMgr;
 
+    StartupTrace::mark("Controllers");
     ImportController importController;
     importController.setNetworkAccessManagerFactory(namFactory);
     importController.setReservationManager(&resMgr);
@@ -384,6 +399,7 @@ int main(int argc, char **argv)
     MatrixController matrixController;
     MatrixControllerInstance::instance = &matrixController;
 
+    StartupTrace::mark("QML engine");
     registerKItineraryTypes();
     registerApplicationSingletons();
 
@@ -406,6 +422,7 @@ int main(int argc, char **argv)
     engine.addImageProvider(u"org.kde.pkpass"_s, pkPassImageProvider);
 
     KLocalization::setupLocalizedContext(&engine);
+    StartupTrace::mark("QML loading");
     engine.loadFromModule("org.kde.itinerary", "Main");
 
     // Exit on QML load error.
@@ -426,9 +443,22 @@ int main(int argc, char **argv)
     intentHandler.handleIntent(Activity::getIntent());
 #endif
 
+    StartupTrace::mark("Event loop");
+    QTimer::singleShot(0, &app, &StartupTrace::finish);
+
     if (parser.isSet(selfTestOpt)) {
         QTimer::singleShot(std::chrono::milliseconds(250), &app, &QCoreApplication::quit);
+    } else {
+        // don't compete with the startup work
+        QTimer::singleShot(std::chrono::seconds(10), &resMgr, &ReservationManager::upgradeStoredReservations);
     }
 
+    // we might not get a chance to shut down properly once suspended
+    QObject::connect(&app, &QGuiApplication::applicationStateChanged, &app, [](Qt::ApplicationState state) {
+        if (state == Qt::ApplicationSuspended) {
+            FileWriteQueue::flush();
+        }
+    });
+
     return app.exec();
 }
@@ -66,7 +66,8 @@ QString MatrixSyncContent::readBatch(const MatrixSyncStateEvent &event, Reservat
 
     if (resMgr->hasBatch(batchId)) {
         qCDebug(Log) << "updating reservation" << batchId;
-        resMgr->updateBatch(changes);
+        // post-processed by the sending side, which isn't necessarily using the same version as we do
+        resMgr->updateBatch(changes, false);
         qCDebug(Log) << "updated reservation" << batchId;
     } else {
         qCDebug(Log) << "creating reservation" << batchId;
@@ -82,7 +83,8 @@ QString MatrixSyncContent::readBatch(const MatrixSyncStateEvent &event, Reservat
 
 MatrixSyncStateEvent MatrixSyncContent::stateEventForLiveData(const QString &batchId)
 {
-    const auto ld = LiveData::load(batchId);
+    auto ld = LiveData::load(batchId);
+    ld.trip = ld.tripWithPath();
     MatrixSyncStateEvent state(MatrixSync::LiveDataEventType, batchId);
     state.setContent(QJsonDocument(LiveData::toJson(ld)).toJson(QJsonDocument::Compact));
     return state;
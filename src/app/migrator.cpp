@@ -39,6 +39,21 @@ void Migrator::run()
         case 2:
             recomputeBatchTimes();
             ++version;
+            [[fallthrough]];
+        case 3:
+            importReservationFiles();
+            ++version;
+            [[fallthrough]];
+        case 4:
+            importBatchFiles();
+            ++version;
+            [[fallthrough]];
+        case 5:
+            // retried on the next start if incomplete, nothing reads the legacy files anymore
+            if (!importLiveDataFiles()) {
+                break;
+            }
+            ++version;
             // add future updates here with [[fallthrough]]
             break;
         default:
@@ -140,3 +155,62 @@ void Migrator::recomputeBatchTimes()
         ReservationManager::storeBatch(batchId, batch);
     }
 }
+
+// move from one JSON-LD file per reservation to the single file reservation store
+void Migrator::importReservationFiles()
+{
+    const auto basePath = ReservationManager::reservationsBasePath();
+    if (!QDir(basePath).exists()) {
+        return;
+    }
+
+    const auto fileCount = QDir(basePath).entryList({u"*.jsonld"_s}, QDir::Files).size();
+    const auto importCount = ReservationManager::importReservationFiles(basePath);
+    qCDebug(Log) << "imported" << importCount << "of" << fileCount << "reservations";
+
+    // keep the old files around if anything went wrong, loading falls back to those
+    if (importCount == fileCount) {
+        QDir(basePath).removeRecursively();
+    }
+}
+
+// move from one JSON file per batch to the single file batch store
+void Migrator::importBatchFiles()
+{
+    const auto basePath = ReservationManager::batchesBasePath();
+    if (!QDir(basePath).exists()) {
+        return;
+    }
+
+    // might have happened already when loading batches in a previous migration step
+    if (!QFile::exists(ReservationManager::batchesStorePath())) {
+        const auto fileCount = QDir(basePath).entryList({u"*.json"_s}, QDir::Files).size();
+        const auto importCount = ReservationManager::importBatchFiles(basePath);
+        qCDebug(Log) << "imported" << importCount << "of" << fileCount << "batches";
+        if (importCount != fileCount) {
+            return;
+        }
+    }
+    QDir(basePath).removeRecursively();
+}
+
+// move from one file pair per batch to the single file live data store
+bool Migrator::importLiveDataFiles()
+{
+    const auto basePath = LiveData::basePath();
+    if (!QDir(basePath).exists()) {
+        return true;
+    }
+
+    const auto fileCount = QDir(basePath).entryList({u"*.json"_s}, QDir::Files).size();
+    const auto importCount = LiveData::importLegacyFiles();
+    qCDebug(Log) << "imported" << importCount << "of" << fileCount << "live data entries";
+
+    // imported files are removed already, anything left failed to import
+    if (importCount != fileCount) {
+        qCWarning(Log) << "Failed to import" << (fileCount - importCount) << "live data entries, keeping them in" << basePath;
+        return false;
+    }
+    QDir(basePath).removeRecursively();
+    return true;
+}
@@ -16,6 +16,9 @@ private:
     static void dropTripGroupExpandCollapseState();
     static void moveLiveData();
     static void recomputeBatchTimes();
+    static void importReservationFiles();
+    static void importBatchFiles();
+    [[nodiscard]] static bool importLiveDataFiles();
 };
 
 #endif
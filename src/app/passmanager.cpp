@@ -5,6 +5,7 @@
 
 #include "passmanager.h"
 
+#include "filewritequeue.h"
 #include "genericpkpass.h"
 #include "jsonio.h"
 #include "logging.h"
@@ -308,6 +309,7 @@ QHash<int, QByteArray> PassManager::roleNames() const
 
 void PassManager::load()
 {
+    FileWriteQueue::flush();
     QDirIterator it(basePath(), QDir::Files);
     while (it.hasNext()) {
         it.next();
@@ -324,20 +326,18 @@ void PassManager::load()
 
 bool PassManager::write(const QVariant &data, const QString &id) const
 {
-    auto path = basePath();
-    QDir().mkpath(path);
-    path += id;
-    QFile f(path);
-    if (!f.open(QFile::WriteOnly)) {
-        qCWarning(Log) << "Failed to open file:" << f.fileName() << f.errorString();
+    const auto json = JsonLdDocument::toJson(data);
+    if (json.isEmpty()) {
+        qCWarning(Log) << "Failed to serialize pass:" << id;
         return false;
     }
-    f.write(JsonIO::write(JsonLdDocument::toJson(data)));
+    FileWriteQueue::write(basePath() + id, JsonIO::write(json));
     return true;
 }
 
 QByteArray PassManager::rawData(const Entry &entry) const
 {
+    FileWriteQueue::flush();
     QFile f(basePath() + entry.id);
     if (!f.open(QFile::ReadOnly)) {
         qCWarning(Log) << "Failed to open file:" << f.fileName() << f.errorString();
@@ -391,7 +391,7 @@ bool PassManager::removeRows(int row, int count, const QModelIndex &parent)
     const auto path = basePath();
     beginRemoveRows({}, row, row + count - 1);
     for (int i = row; i < row + count; ++i) {
-        QFile::remove(path + m_entries[i].id);
+        FileWriteQueue::remove(path + m_entries[i].id);
     }
     m_entries.erase(m_entries.begin() + row, m_entries.begin() + row + count);
     endRemoveRows();
@@ -0,0 +1,361 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "recordstore.h"
+
+#include "logging.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cerrno>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace Qt::Literals;
+
+constexpr inline const auto FileMagic = "ITRS"_ba;
+constexpr inline const quint32 FormatVersion = 1;
+constexpr inline const qint64 FileHeaderSize = 8;
+constexpr inline const qint64 RecordHeaderSize = 8;
+constexpr inline const quint32 MaximumKeySize = 1024;
+
+// don't bother compacting files with less than this amount of superseded data
+constexpr inline const qint64 MinimumGarbageForCompaction = 1024 * 1024;
+
+[[nodiscard]] static qint64 recordSize(qint64 keySize, qint64 valueSize)
+{
+    return RecordHeaderSize + keySize + valueSize;
+}
+
+[[nodiscard]] static QByteArray fileHeader()
+{
+    QByteArray header(FileMagic);
+    header.resize(FileHeaderSize);
+    qToLittleEndian<quint32>(FormatVersion, header.data() + 4);
+    return header;
+}
+
+[[nodiscard]] static QByteArray recordHeader(qint64 keySize, qint64 valueSize)
+{
+    QByteArray header;
+    header.resize(RecordHeaderSize);
+    qToLittleEndian<quint32>((quint32)keySize, header.data());
+    qToLittleEndian<quint32>((quint32)valueSize, header.data() + 4);
+    return header;
+}
+
+RecordStore::RecordStore(const QString &fileName)
+    : m_fileName(fileName)
+{
+    open();
+}
+
+RecordStore::~RecordStore()
+{
+    sync();
+}
+
+QString RecordStore::fileName() const
+{
+    return m_fileName;
+}
+
+bool RecordStore::isEmpty() const
+{
+    return m_index.isEmpty();
+}
+
+bool RecordStore::contains(const QString &key) const
+{
+    return m_index.contains(key);
+}
+
+std::vector<QString> RecordStore::keys() const
+{
+    std::vector<QString> keys;
+    keys.reserve(m_index.size());
+    std::copy(m_index.keyBegin(), m_index.keyEnd(), std::back_inserter(keys));
+    return keys;
+}
+
+std::vector<std::pair<QString, QByteArray>> RecordStore::readAll() const
+{
+    std::vector<std::pair<QString, QByteArray>> records;
+    if (m_index.isEmpty() || !m_file.isOpen() || !m_file.seek(0)) {
+        return records;
+    }
+
+    const auto data = m_file.readAll();
+    std::vector<std::pair<QString, Entry>> entries;
+    entries.reserve(m_index.size());
+    for (auto it = m_index.constBegin(); it != m_index.constEnd(); ++it) {
+        entries.emplace_back(it.key(), it.value());
+    }
+    std::ranges::sort(entries, {}, [](const auto &entry) { return entry.second.offset; });
+
+    records.reserve(entries.size());
+    for (const auto &[key, entry] : entries) {
+        if (entry.offset + entry.size > data.size()) {
+            qCWarning(Log) << "Failed to read record from record store:" << m_fileName << key;
+            continue;
+        }
+        records.emplace_back(key, data.mid(entry.offset, entry.size));
+    }
+    return records;
+}
+
+qsizetype RecordStore::valueSize(const QString &key) const
+{
+    return m_index.value(key).size;
+}
+
+QByteArray RecordStore::read(const QString &key) const
+{
+    const auto it = m_index.constFind(key);
+    if (it == m_index.constEnd() || !m_file.isOpen()) {
+        return {};
+    }
+
+    if (!m_file.seek((*it).offset)) {
+        qCWarning(Log) << "Failed to seek in record store:" << m_fileName << m_file.errorString();
+        return {};
+    }
+    const auto value = m_file.read((*it).size);
+    if (value.size() != (qsizetype)(*it).size) {
+        qCWarning(Log) << "Failed to read record from record store:" << m_fileName << key << m_file.errorString();
+        return {};
+    }
+    return value;
+}
+
+void RecordStore::write(const QString &key, const QByteArray &value)
+{
+    if (value.isEmpty()) {
+        remove(key);
+        return;
+    }
+    appendRecord(key, value);
+}
+
+void RecordStore::remove(const QString &key)
+{
+    if (!m_index.contains(key)) {
+        return;
+    }
+    appendRecord(key, {});
+}
+
+void RecordStore::clear()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    m_index.clear();
+    m_liveSize = 0;
+    m_garbageSize = 0;
+    m_file.resize(0);
+    m_file.seek(0);
+    m_file.write(fileHeader());
+    m_file.flush();
+    m_needsSync = true;
+}
+
+void RecordStore::compact()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    QSaveFile f(m_fileName);
+    if (!f.open(QFile::WriteOnly)) {
+        qCWarning(Log) << "Failed to open file for compacting record store:" << f.fileName() << f.errorString();
+        return;
+    }
+
+    f.write(fileHeader());
+    qint64 pos = FileHeaderSize;
+    QHash<QString, Entry> index;
+    index.reserve(m_index.size());
+    for (auto it = m_index.constBegin(); it != m_index.constEnd(); ++it) {
+        const auto value = read(it.key());
+        if (value.isEmpty()) {
+            continue;
+        }
+        const auto keyData = it.key().toUtf8();
+        f.write(recordHeader(keyData.size(), value.size()));
+        f.write(keyData);
+        f.write(value);
+        index.insert(it.key(), {.offset = pos + RecordHeaderSize + keyData.size(), .size = (quint32)value.size()});
+        pos += recordSize(keyData.size(), value.size());
+    }
+
+    m_file.close();
+    if (!f.commit()) {
+        qCWarning(Log) << "Failed to write compacted record store:" << f.fileName() << f.errorString();
+        open();
+        return;
+    }
+
+    qCDebug(Log) << "compacted" << m_fileName << "from" << (m_liveSize + m_garbageSize + FileHeaderSize) << "to" << pos << "bytes";
+    if (!m_file.open(QFile::ReadWrite)) {
+        qCWarning(Log) << "Failed to reopen record store:" << m_fileName << m_file.errorString();
+        m_index.clear();
+        return;
+    }
+    m_index = std::move(index);
+    m_liveSize = pos - FileHeaderSize;
+    m_garbageSize = 0;
+    m_needsSync = false; // QSaveFile::commit() did that already
+}
+
+void RecordStore::sync()
+{
+    if (!m_needsSync || !m_file.isOpen()) {
+        return;
+    }
+
+#if defined(Q_OS_WIN)
+    const auto res = ::_commit(m_file.handle());
+#elif defined(Q_OS_LINUX)
+    const auto res = ::fdatasync(m_file.handle());
+#else
+    const auto res = ::fsync(m_file.handle());
+#endif
+    if (res != 0) {
+        qCWarning(Log) << "Failed to sync record store:" << m_fileName << qt_error_string(errno);
+        return;
+    }
+    m_needsSync = false;
+}
+
+void RecordStore::open()
+{
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+    m_file.setFileName(m_fileName);
+    if (!m_file.open(QFile::ReadWrite)) {
+        qCWarning(Log) << "Failed to open record store:" << m_fileName << m_file.errorString();
+        return;
+    }
+
+    scan();
+    if (m_garbageSize > MinimumGarbageForCompaction && m_garbageSize > m_liveSize) {
+        compact();
+    }
+}
+
+void RecordStore::scan()
+{
+    m_index.clear();
+    m_liveSize = 0;
+    m_garbageSize = 0;
+
+    const auto fileSize = m_file.size();
+    if (fileSize == 0) {
+        m_file.write(fileHeader());
+        m_file.flush();
+        return;
+    }
+
+    const auto header = m_file.read(FileHeaderSize);
+    if (header.size() != FileHeaderSize || !header.startsWith(FileMagic) || qFromLittleEndian<quint32>(header.constData() + 4) != FormatVersion) {
+        // don't destroy what might still be recoverable data
+        qCWarning(Log) << "Invalid record store file, moving it out of the way:" << m_fileName;
+        m_file.close();
+        QFile::remove(m_fileName + ".invalid"_L1);
+        QFile::rename(m_fileName, m_fileName + ".invalid"_L1);
+        if (m_file.open(QFile::ReadWrite | QFile::Truncate)) {
+            m_file.write(fileHeader());
+            m_file.flush();
+        }
+        return;
+    }
+
+    qint64 pos = FileHeaderSize;
+    while (pos + RecordHeaderSize <= fileSize) {
+        const auto recHeader = m_file.read(RecordHeaderSize);
+        if (recHeader.size() != RecordHeaderSize) {
+            break;
+        }
+        const auto keySize = qFromLittleEndian<quint32>(recHeader.constData());
+        const auto valueSize = qFromLittleEndian<quint32>(recHeader.constData() + 4);
+        const auto size = recordSize(keySize, valueSize);
+        if (keySize == 0 || keySize > MaximumKeySize || pos + size > fileSize) {
+            break;
+        }
+
+        const auto key = QString::fromUtf8(m_file.read(keySize));
+        if (const auto it = m_index.constFind(key); it != m_index.constEnd()) {
+            const auto oldSize = recordSize(keySize, (*it).size);
+            m_liveSize -= oldSize;
+            m_garbageSize += oldSize;
+        }
+        if (valueSize == 0) {
+            m_index.remove(key);
+            m_garbageSize += size;
+        } else {
+            m_index.insert(key, {.offset = pos + RecordHeaderSize + keySize, .size = valueSize});
+            m_liveSize += size;
+        }
+
+        pos += size;
+        if (!m_file.seek(pos)) {
+            break;
+        }
+    }
+
+    if (pos != fileSize) {
+        // incomplete write, e.g. due to a crash
+        qCWarning(Log) << "Discarding incomplete records at the end of" << m_fileName << pos << fileSize;
+        m_file.resize(pos);
+    }
+}
+
+void RecordStore::appendRecord(const QString &key, const QByteArray &value)
+{
+    if (!m_file.isOpen()) {
+        qCWarning(Log) << "Record store not open, discarding write:" << m_fileName << key;
+        return;
+    }
+
+    const auto keyData = key.toUtf8();
+    if (keyData.isEmpty() || keyData.size() > (qsizetype)MaximumKeySize) {
+        qCWarning(Log) << "Invalid record store key:" << key;
+        return;
+    }
+
+    const auto pos = m_file.size();
+    QByteArray record = recordHeader(keyData.size(), value.size());
+    record.reserve(recordSize(keyData.size(), value.size()));
+    record += keyData;
+    record += value;
+    if (!m_file.seek(pos) || m_file.write(record) != record.size() || !m_file.flush()) {
+        qCWarning(Log) << "Failed to write to record store:" << m_fileName << m_file.errorString();
+        m_file.resize(pos);
+        return;
+    }
+    m_needsSync = true;
+
+    if (const auto it = m_index.constFind(key); it != m_index.constEnd()) {
+        const auto oldSize = recordSize(keyData.size(), (*it).size);
+        m_liveSize -= oldSize;
+        m_garbageSize += oldSize;
+    }
+    if (value.isEmpty()) {
+        m_index.remove(key);
+        m_garbageSize += record.size();
+    } else {
+        m_index.insert(key, {.offset = pos + RecordHeaderSize + keyData.size(), .size = (quint32)value.size()});
+        m_liveSize += record.size();
+    }
+}
@@ -0,0 +1,93 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef RECORDSTORE_H
+#define RECORDSTORE_H
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+
+#include <utility>
+#include <vector>
+
+class QByteArray;
+
+/** Keyed append-only storage of binary (usually CBOR) values in a single file.
+ *
+ *  Every write appends a new record to the end of the file, superseding any previous
+ *  record for the same key. Removals append an empty tombstone record. The offset index
+ *  is rebuilt by a single sequential scan of the record headers when opening the file,
+ *  the values themselves are only read on demand.
+ *
+ *  Space taken up by superseded records is reclaimed by compact(), which is done
+ *  automatically when opening a file with too much garbage in it.
+ *
+ *  Writes are handed to the operating system right away, but not forced to disk.
+ *  Records written since the last sync() can therefore be lost on a power loss
+ *  or operating system crash (not on an application crash), the file is recovered
+ *  to the last complete record on opening in that case. Users storing data that
+ *  can't be restored from elsewhere need to call sync() once a change is complete.
+ *
+ *  On-disk format (all integers little endian):
+ *  - file header: 4 byte magic "ITRS", 4 byte format version
+ *  - records: 4 byte key length, 4 byte value length, UTF-8 key, value
+ */
+class RecordStore
+{
+public:
+    explicit RecordStore(const QString &fileName);
+    ~RecordStore();
+
+    [[nodiscard]] QString fileName() const;
+
+    [[nodiscard]] bool isEmpty() const;
+    [[nodiscard]] bool contains(const QString &key) const;
+    /** All keys with a value in this store, in no particular order. */
+    [[nodiscard]] std::vector<QString> keys() const;
+
+    /** All keys and values, in file order.
+     *  This reads the entire file sequentially, which is much faster than
+     *  calling read() for every key when all values are needed.
+     */
+    [[nodiscard]] std::vector<std::pair<QString, QByteArray>> readAll() const;
+    /** Size of the value stored for @p key, without reading it. */
+    [[nodiscard]] qsizetype valueSize(const QString &key) const;
+    /** Returns the value stored for @p key, or a null byte array if there is none. */
+    [[nodiscard]] QByteArray read(const QString &key) const;
+    /** Stores @p value for @p key, replacing any previous value. */
+    void write(const QString &key, const QByteArray &value);
+    /** Removes the value for @p key. */
+    void remove(const QString &key);
+    /** Removes all values. */
+    void clear();
+
+    /** Rewrite the file with only the current records. */
+    void compact();
+    /** Force all writes so far to disk.
+     *  This is expensive, so prefer calling this once after a set of changes.
+     *  Does nothing if there are no unsynced writes.
+     */
+    void sync();
+
+private:
+    struct Entry {
+        qint64 offset = 0; // of the value
+        quint32 size = 0; // of the value
+    };
+
+    void open();
+    void scan();
+    void appendRecord(const QString &key, const QByteArray &value);
+
+    QString m_fileName;
+    mutable QFile m_file;
+    QHash<QString, Entry> m_index;
+    qint64 m_liveSize = 0;
+    qint64 m_garbageSize = 0;
+    bool m_needsSync = false;
+};
+
+#endif // RECORDSTORE_H
@@ -0,0 +1,108 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "reservationcache.h"
+
+ReservationCache::ReservationCache(qsizetype budget)
+    : m_budget(budget)
+{
+}
+
+ReservationCache::~ReservationCache() = default;
+
+qsizetype ReservationCache::budget() const
+{
+    return m_budget;
+}
+
+void ReservationCache::setBudget(qsizetype budget)
+{
+    m_budget = budget;
+    evict({});
+}
+
+QVariant ReservationCache::value(const QString &resId)
+{
+    const auto it = m_index.constFind(resId);
+    if (it == m_index.constEnd()) {
+        ++m_stats.misses;
+        return {};
+    }
+
+    ++m_stats.hits;
+    auto &entries = m_entries[(*it.value()).priority];
+    entries.splice(entries.begin(), entries, it.value());
+    return (*it.value()).res;
+}
+
+bool ReservationCache::contains(const QString &resId) const
+{
+    return m_index.contains(resId);
+}
+
+void ReservationCache::insert(const QString &resId, const QVariant &res, qsizetype cost, Priority priority)
+{
+    remove(resId);
+
+    auto &entries = m_entries[priority];
+    entries.push_front({.resId = resId, .res = res, .cost = cost, .priority = priority});
+    m_index.insert(resId, entries.begin());
+    m_stats.cost += cost;
+    ++m_stats.count;
+
+    evict(resId);
+}
+
+void ReservationCache::remove(const QString &resId)
+{
+    const auto it = m_index.constFind(resId);
+    if (it == m_index.constEnd()) {
+        return;
+    }
+
+    const auto entryIt = it.value();
+    m_stats.cost -= (*entryIt).cost;
+    --m_stats.count;
+    m_entries[(*entryIt).priority].erase(entryIt);
+    m_index.erase(it);
+}
+
+void ReservationCache::clear()
+{
+    for (auto &entries : m_entries) {
+        entries.clear();
+    }
+    m_index.clear();
+    m_stats.cost = 0;
+    m_stats.count = 0;
+}
+
+ReservationCache::Statistics ReservationCache::statistics() const
+{
+    return m_stats;
+}
+
+void ReservationCache::evict(const QString &keepResId)
+{
+    while (m_stats.cost > m_budget) {
+        // least recently used low priority entry first, never the one we just inserted
+        EntryList *entries = nullptr;
+        for (const auto priority : {LowPriority, NormalPriority}) {
+            if (auto &l = m_entries[priority]; !l.empty() && l.back().resId != keepResId) {
+                entries = &l;
+                break;
+            }
+        }
+        if (!entries) {
+            return;
+        }
+
+        m_stats.cost -= entries->back().cost;
+        --m_stats.count;
+        m_index.remove(entries->back().resId);
+        entries->pop_back();
+        ++m_stats.evictions;
+    }
+}
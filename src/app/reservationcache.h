@@ -0,0 +1,74 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef RESERVATIONCACHE_H
+#define RESERVATIONCACHE_H
+
+#include <QHash>
+#include <QString>
+#include <QVariant>
+
+#include <list>
+
+/** Size-bounded LRU cache for deserialized reservations.
+ *  Cost is measured in bytes of the serialized reservation data, which
+ *  is a reasonable approximation of the memory the deserialized data needs.
+ *  Entries with low priority (e.g. reservations in the past) are evicted
+ *  before any entry with normal priority is.
+ */
+class ReservationCache
+{
+public:
+    explicit ReservationCache(qsizetype budget = DefaultBudget);
+    ~ReservationCache();
+
+    /** Default cache budget in bytes. */
+    static constexpr inline const qsizetype DefaultBudget = 4 * 1024 * 1024;
+
+    [[nodiscard]] qsizetype budget() const;
+    void setBudget(qsizetype budget);
+
+    /** Returns the cached reservation for @p resId, or a null variant if not cached. */
+    [[nodiscard]] QVariant value(const QString &resId);
+    [[nodiscard]] bool contains(const QString &resId) const;
+
+    enum Priority {
+        NormalPriority,
+        LowPriority,
+    };
+
+    /** Insert or replace the cache entry for @p resId. */
+    void insert(const QString &resId, const QVariant &res, qsizetype cost, Priority priority);
+    void remove(const QString &resId);
+    void clear();
+
+    struct Statistics {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 evictions = 0;
+        qsizetype count = 0;
+        qsizetype cost = 0;
+    };
+    /** Cache usage statistics, for tuning the budget. */
+    [[nodiscard]] Statistics statistics() const;
+
+private:
+    struct Entry {
+        QString resId;
+        QVariant res;
+        qsizetype cost = 0;
+        Priority priority = NormalPriority;
+    };
+    using EntryList = std::list<Entry>;
+
+    void evict(const QString &keepResId);
+
+    EntryList m_entries[2]; // per priority, most recently used first
+    QHash<QString, EntryList::iterator> m_index;
+    qsizetype m_budget = DefaultBudget;
+    Statistics m_stats;
+};
+
+#endif // RESERVATIONCACHE_H
@@ -10,7 +10,9 @@
 #include "json.h"
 #include "jsonio.h"
 #include "logging.h"
+#include "recordstore.h"
 #include "reservationhelper.h"
+#include "startuptrace.h"
 
 #include <KItinerary/Event>
 #include <KItinerary/ExtractorPostprocessor>
@@ -23,6 +25,8 @@
 
 #include <KLocalizedString>
 
+#include <kitinerary_version.h>
+
 #include <QDate>
 #include <QDir>
 #include <QDirIterator>
@@ -31,10 +35,13 @@
 #include <QJsonObject>
 #include <QList>
 #include <QScopeGuard>
+#include <QSettings>
 #include <QStandardPaths>
 #include <QUrl>
 #include <QUuid>
 
+#include <utility>
+
 using namespace KItinerary;
 using namespace Qt::Literals;
 
@@ -72,19 +79,65 @@ ReservationBatch ReservationBatch::fromJson(const QJsonObject &obj)
 }
 
 
-bool ReservationManager::BatchComparator::operator()(const QString &lhs, const QString &rhs) const
+[[nodiscard]] static RecordStore& reservationStore()
+{
+    static RecordStore s_store(ReservationManager::reservationsStorePath());
+    return s_store;
+}
+
+[[nodiscard]] static RecordStore& batchStore()
+{
+    static RecordStore s_store(ReservationManager::batchesStorePath());
+    return s_store;
+}
+
+// reservations and batches can't be restored from elsewhere, so make sure changes are on disk once complete
+static void syncStores()
+{
+    reservationStore().sync();
+    batchStore().sync();
+}
+
+// KItinerary version the post-processed data in the reservation store was created with
+constexpr inline auto PostprocessorVersion = QLatin1StringView(KITINERARY_VERSION_STRING);
+constexpr inline auto PostprocessorVersionSettingsKey = "ReservationStore/PostprocessorVersion"_L1;
+// number of reservations to upgrade in one go in the background
+constexpr inline const std::size_t UpgradeChunkSize = 20;
+
+// reservation store records: the JSON-LD data wrapped in an object together with the
+// version of the post-processor that produced it, plain JSON-LD data for unprocessed records
+struct ReservationRecord {
+    QJsonValue data;
+    QString postprocessorVersion;
+};
+
+[[nodiscard]] static ReservationRecord readReservationRecord(const QByteArray &data)
 {
-    return ReservationBatch::isBefore(m_resMgr->m_batchToResMap.value(lhs), m_resMgr->m_batchToResMap.value(rhs));
+    const auto val = JsonIO::read(data);
+    if (const auto obj = val.toObject(); obj.contains("data"_L1) && !obj.contains("@type"_L1)) {
+        return {.data = obj.value("data"_L1), .postprocessorVersion = obj.value("postprocessorVersion"_L1).toString()};
+    }
+    return {.data = val, .postprocessorVersion = {}};
 }
 
-bool ReservationManager::BatchComparator::operator()(const QString &lhs, const QDateTime &rhs) const
+[[nodiscard]] static QByteArray writeReservationRecord(const QJsonValue &data, QLatin1StringView postprocessorVersion)
 {
-    return m_resMgr->m_batchToResMap.value(lhs).startDateTime() < rhs;
+    if (postprocessorVersion.isEmpty()) {
+        return JsonIO::write(data);
+    }
+    return JsonIO::write(QJsonObject{
+        {"data"_L1, data},
+        {"postprocessorVersion"_L1, postprocessorVersion},
+    });
 }
 
-bool ReservationManager::BatchComparator::operator()(const QDateTime &lhs, const QString &rhs) const
+[[nodiscard]] static QList<QVariant> parseReservationRecord(const ReservationRecord &record)
 {
-    return lhs < m_resMgr->m_batchToResMap.value(rhs).startDateTime();
+    const auto &val = record.data;
+    if (!(val.isArray() && val.toArray().size() == 1) && !val.isObject()) {
+        return {};
+    }
+    return JsonLdDocument::fromJson(val.isArray() ? val.toArray() : QJsonArray({val.toObject()}));
 }
 
 
@@ -93,11 +146,19 @@ ReservationManager::ReservationManager(QObject *parent)
     , m_validator(ReservationManager::validator())
 {
     m_validator.setAcceptOnlyCompleteElements(true);
+    m_upgradeThreadPool.setMaxThreadCount(1);
 
     loadBatches();
 }
 
-ReservationManager::~ReservationManager() = default;
+ReservationManager::~ReservationManager()
+{
+    // results of pending background work are delivered to us
+    m_loadThreadPool.clear();
+    m_loadThreadPool.waitForDone();
+    m_upgradeThreadPool.clear();
+    m_upgradeThreadPool.waitForDone();
+}
 
 KItinerary::ExtractorValidator ReservationManager::validator()
 {
@@ -130,60 +191,122 @@ QVariant ReservationManager::reservation(const QString &id) const
         return {};
     }
 
-    const auto it = m_reservations.constFind(id);
-    if (it != m_reservations.constEnd()) {
-        return it.value();
+    if (const auto it = m_pendingReservations.constFind(id); it != m_pendingReservations.constEnd()) {
+        return it.value().res;
+    }
+    if (auto res = m_cache.value(id); !res.isNull()) {
+        return res;
     }
+    return loadReservationsInBatch(batchForReservation(id)).value(id);
+}
 
-    loadReservationsInBatch(batchForReservation(id));
-    return m_reservations.value(id);
+void ReservationManager::setCacheBudget(qsizetype budget)
+{
+    m_cache.setBudget(budget);
 }
 
-void ReservationManager::loadReservation(const QString &resId) const
+ReservationCache::Statistics ReservationManager::cacheStatistics() const
 {
-    const QString resPath = reservationsBasePath() + resId + ".jsonld"_L1;
-    QFile f(resPath);
-    if (!f.open(QFile::ReadOnly)) {
-        qCWarning(Log) << "Failed to open JSON-LD reservation data file:" << resPath << f.errorString();
-        return;
+    return m_cache.statistics();
+}
+
+// past elements are less likely to be needed again
+[[nodiscard]] static ReservationCache::Priority cachePriority(const QDateTime &endDt)
+{
+    return endDt.isValid() && endDt < QDateTime::currentDateTime() ? ReservationCache::LowPriority : ReservationCache::NormalPriority;
+}
+
+// read serialized reservation data, from the store or the legacy storage
+[[nodiscard]] static QByteArray readReservationData(const QString &resId)
+{
+    auto data = reservationStore().read(resId);
+    if (data.isEmpty()) {
+        // legacy one file per reservation storage, not migrated yet
+        const QString resPath = ReservationManager::reservationsBasePath() + resId + ".jsonld"_L1;
+        QFile f(resPath);
+        if (!f.open(QFile::ReadOnly)) {
+            qCWarning(Log) << "Failed to load reservation data:" << resId << f.errorString();
+            return {};
+        }
+        data = f.readAll();
     }
+    return data;
+}
 
-    const auto val = JsonIO::read(f.readAll());
-    if (!(val.isArray() && val.toArray().size() == 1) && !val.isObject()) {
-        qCWarning(Log) << "Invalid JSON-LD reservation data file:" << resPath;
-        return;
+struct DecodedReservation {
+    QVariant res;
+    QByteArray upgradedRecord; // set if post-processing had to be re-run
+};
+
+// deserialize, post-process if needed, and validate
+// this has no side-effects and thus can be used from any thread
+[[nodiscard]] static DecodedReservation decodeReservation(const QString &resId, const QByteArray &data, const ExtractorValidator &validator)
+{
+    if (data.isEmpty()) {
+        return {};
     }
 
-    const auto resData = JsonLdDocument::fromJson(val.isArray() ? val.toArray() : QJsonArray({val.toObject()}));
+    const auto record = readReservationRecord(data);
+    if (!(record.data.isArray() && record.data.toArray().size() == 1) && !record.data.isObject()) {
+        qCWarning(Log) << "Invalid JSON-LD reservation data:" << resId;
+        return {};
+    }
+
+    const auto resData = parseReservationRecord(record);
     if (resData.size() != 1) {
-        qCWarning(Log) << "Unable to parse JSON-LD reservation data file:" << resPath;
-        return;
+        qCWarning(Log) << "Unable to parse JSON-LD reservation data:" << resId;
+        return {};
     }
 
-    // re-run post-processing to benefit from newer augmentations
-    ExtractorPostprocessor postproc;
-    postproc.process(resData);
-    if (postproc.result().size() != 1) {
-        qCWarning(Log) << "Post-processing discarded the reservation:" << resPath;
-        return;
+    DecodedReservation decoded;
+    const bool needsPostProcessing = record.postprocessorVersion != PostprocessorVersion;
+    if (needsPostProcessing) {
+        // re-run post-processing to benefit from newer augmentations
+        ExtractorPostprocessor postproc;
+        postproc.process(resData);
+        if (postproc.result().size() != 1) {
+            qCWarning(Log) << "Post-processing discarded the reservation:" << resId;
+            return {};
+        }
+        decoded.res = postproc.result().at(0);
+    } else {
+        decoded.res = resData.at(0);
     }
 
-    const auto res = postproc.result().at(0);
-    if (!m_validator.isValidElement(res)) {
-        qCWarning(Log) << "Validation discarded the reservation:" << resPath;
-        return;
+    if (!validator.isValidElement(decoded.res)) {
+        qCWarning(Log) << "Validation discarded the reservation:" << resId;
+        return {};
+    }
+    if (needsPostProcessing) {
+        decoded.upgradedRecord = writeReservationRecord(JsonLdDocument::toJson(decoded.res), PostprocessorVersion);
     }
-    m_reservations.insert(resId, res);
-    qCDebug(Log) << "reservations loaded:" << m_reservations.size();
+    return decoded;
 }
 
-void ReservationManager::loadReservationsInBatch(const QString &batchId) const
+QVariant ReservationManager::loadReservation(const QString &resId) const
+{
+    auto decoded = decodeReservation(resId, readReservationData(resId), m_validator);
+    if (!decoded.upgradedRecord.isEmpty()) {
+        reservationStore().write(resId, decoded.upgradedRecord);
+    }
+    return decoded.res;
+}
+
+QHash<QString, QVariant> ReservationManager::loadReservationsInBatch(const QString &batchId) const
 {
     const auto &batch = m_batchToResMap.value(batchId);
+    QHash<QString, QVariant> reservations;
+    reservations.reserve(batch.reservationIds().size());
     for (const auto &resId : batch.reservationIds()) {
-        loadReservation(resId);
+        // not written to storage yet during bulk updates
+        const auto pendingIt = m_pendingReservations.constFind(resId);
+        reservations.insert(resId, pendingIt != m_pendingReservations.constEnd() ? pendingIt.value().res : loadReservation(resId));
     }
+    return cacheBatch(batch, std::move(reservations));
+}
 
+QHash<QString, QVariant> ReservationManager::cacheBatch(const ReservationBatch &batch, QHash<QString, QVariant> &&reservations) const
+{
     // cross-merge multi-traveler/multi-ticket incidences
     for (const auto &resId1 : batch.reservationIds()) {
         for (const auto &resId2 : batch.reservationIds()) {
@@ -191,12 +314,79 @@ void ReservationManager::loadReservationsInBatch(const QString &batchId) const
                 continue;
             }
 
-            auto &res1 = m_reservations[resId1];
-            auto &res2 = m_reservations[resId2];
+            auto &res1 = reservations[resId1];
+            auto &res2 = reservations[resId2];
             res1 = MergeUtil::mergeIncidence(res1, res2);
             res2 = MergeUtil::mergeIncidence(res2, res1);
         }
     }
+
+    const auto priority = cachePriority(batch.endDateTime().isValid() ? batch.endDateTime() : batch.startDateTime());
+    for (auto it = reservations.constBegin(); it != reservations.constEnd(); ++it) {
+        if (!it.value().isNull()) {
+            m_cache.insert(it.key(), it.value(), std::max<qsizetype>(reservationStore().valueSize(it.key()), 1), priority);
+        }
+    }
+    qCDebug(Log) << "reservations loaded:" << batch.reservationIds().size() << m_cache.statistics().count;
+    return reservations;
+}
+
+void ReservationManager::loadBatchesAsync(const QStringList &batchIds)
+{
+    struct LoadJob {
+        QString resId;
+        QByteArray data;
+        DecodedReservation decoded;
+    };
+
+    const auto revision = m_revision;
+    auto pendingBatches = std::make_shared<qsizetype>(0);
+    for (const auto &batchId : batchIds) {
+        const auto batch = m_batchToResMap.value(batchId);
+        if (std::ranges::all_of(batch.reservationIds(), [this](const auto &resId) { return m_cache.contains(resId); })) {
+            continue;
+        }
+
+        // file I/O here, the expensive decoding is done in parallel on the thread pool
+        std::vector<LoadJob> jobs;
+        jobs.reserve(batch.reservationIds().size());
+        for (const auto &resId : batch.reservationIds()) {
+            jobs.push_back({.resId = resId, .data = readReservationData(resId), .decoded = {}});
+        }
+
+        ++(*pendingBatches);
+        m_loadThreadPool.start([this, batchIds, batch, jobs = std::move(jobs), revision, pendingBatches]() mutable {
+            auto validator = ReservationManager::validator();
+            validator.setAcceptOnlyCompleteElements(true);
+            for (auto &job : jobs) {
+                job.decoded = decodeReservation(job.resId, job.data, validator);
+            }
+
+            QMetaObject::invokeMethod(this, [this, batchIds, batch, jobs = std::move(jobs), revision, pendingBatches]() mutable {
+                // discard the result if anything changed in the meantime
+                if (revision == m_revision) {
+                    QHash<QString, QVariant> reservations;
+                    reservations.reserve((qsizetype)jobs.size());
+                    for (auto &job : jobs) {
+                        if (!job.decoded.upgradedRecord.isEmpty()) {
+                            reservationStore().write(job.resId, job.decoded.upgradedRecord);
+                        }
+                        reservations.insert(job.resId, std::move(job.decoded.res));
+                    }
+                    cacheBatch(batch, std::move(reservations));
+                }
+                if (--(*pendingBatches) == 0) {
+                    Q_EMIT batchesLoaded(batchIds);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    if (*pendingBatches == 0) {
+        QMetaObject::invokeMethod(this, [this, batchIds]() {
+            Q_EMIT batchesLoaded(batchIds);
+        }, Qt::QueuedConnection);
+    }
 }
 
 QString ReservationManager::reservationsBasePath()
@@ -204,11 +394,21 @@ QString ReservationManager::reservationsBasePath()
     return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/reservations/"_L1;
 }
 
+QString ReservationManager::reservationsStorePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/reservations.log"_L1;
+}
+
 QString ReservationManager::batchesBasePath()
 {
     return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/batches/"_L1;
 }
 
+QString ReservationManager::batchesStorePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/batches.log"_L1;
+}
+
 QList<QString> ReservationManager::addReservationsWithPostProcessing(const QList<QVariant> &resData)
 {
     ExtractorPostprocessor postproc;
@@ -218,6 +418,7 @@ QList<QString> ReservationManager::addReservationsWithPostProcessing(const QList
     auto data = postproc.result();
     QList<QString> ids;
     ids.reserve(data.size());
+    ReservationBulkUpdate bulkUpdate(this);
     for (auto &res : data) {
         if (JsonLd::isA<Event>(res)) { // promote Event to EventReservation
             EventReservation ev;
@@ -226,7 +427,7 @@ QList<QString> ReservationManager::addReservationsWithPostProcessing(const QList
             res = ev;
         }
 
-        if (const auto resId = addReservation(res); !resId.isEmpty()) {
+        if (const auto resId = addReservation(res, {}, true); !resId.isEmpty()) {
             ids.push_back(resId);
         }
     }
@@ -235,6 +436,11 @@ QList<QString> ReservationManager::addReservationsWithPostProcessing(const QList
 }
 
 QString ReservationManager::addReservation(const QVariant &res, const QString &resIdHint)
+{
+    return addReservation(res, resIdHint, false);
+}
+
+QString ReservationManager::addReservation(const QVariant &res, const QString &resIdHint, bool isPostProcessed)
 {
     // deal with partial updates
     if (!m_validator.isValidElement(res)) {
@@ -252,25 +458,24 @@ QString ReservationManager::addReservation(const QVariant &res, const QString &r
 
     // look for matching reservations, or matching batches
     // we need to do that within a +/-24h range, so we find unbound elements too
-    // TODO in case this updates the time for an unbound element we need to re-sort, otherwise the prev/next logic fails!
     const auto rangeBegin = SortUtil::startDateTime(res).addDays(-1);
     const auto rangeEnd = rangeBegin.addDays(2);
 
-    const auto beginIt = std::lower_bound(m_batches.begin(), m_batches.end(), rangeBegin, BatchComparator(this));
-    for (auto it = beginIt; it != m_batches.end(); ++it) {
-        const auto otherRes = reservation(*it);
+    for (auto i = m_batchIndex.lowerBound(rangeBegin); i < m_batchIndex.size(); ++i) {
+        const auto batchId = m_batchIndex.batchIds()[i];
+        const auto otherRes = reservation(batchId);
         if (SortUtil::startDateTime(otherRes) > rangeEnd) {
             break; // no hit
         }
         if (MergeUtil::isSame(res, otherRes)) {
             // this is actually an update of otherRes!
             const auto newRes = MergeUtil::merge(otherRes, res);
-            updateReservation(*it, newRes);
-            return *it;
+            updateReservation(batchId, newRes);
+            return batchId;
         }
         if (MergeUtil::isSameIncidence(res, otherRes)) {
             // this is a multi-traveler element, check if we have it as one of the batch elements already
-            auto &batch = m_batchToResMap[*it];
+            auto &batch = m_batchToResMap[batchId];
             for (const auto &batchedId : batch.m_resIds) {
                 const auto batchedRes = reservation(batchedId);
                 if (MergeUtil::isSame(res, batchedRes)) {
@@ -283,33 +488,32 @@ QString ReservationManager::addReservation(const QVariant &res, const QString &r
 
             // truly new, and added to an existing batch
             const QString resId = makeReservationId(resIdHint);
-            storeReservation(resId, res);
+            storeReservation(resId, res, isPostProcessed);
             Q_EMIT reservationAdded(resId);
 
             batch.m_resIds.push_back(resId);
             populateBatchTimes(batch);
-            m_resToBatchMap.insert(resId, *it);
-            storeBatch(*it, batch);
-            Q_EMIT batchChanged(*it);
+            m_batchIndex.update(batchId, batch.startDateTime(), batch.endDateTime());
+            m_resToBatchMap.insert(resId, batchId);
+            persistBatch(batchId);
+            notifyBatchChange(batchId, BatchChange::Changed);
             return resId;
         }
     }
 
     // truly new, and starting a new batch
     const QString resId = makeReservationId(resIdHint);
-    storeReservation(resId, res);
+    storeReservation(resId, res, isPostProcessed);
     Q_EMIT reservationAdded(resId);
 
-    // search for the precise insertion place, beginIt is only the begin of our initial search range
-    const auto insertIt = std::lower_bound(m_batches.begin(), m_batches.end(), SortUtil::startDateTime(res), BatchComparator(this));
-    m_batches.insert(insertIt, resId);
     ReservationBatch batch;
     batch.m_resIds = {resId};
     populateBatchTimes(batch);
+    m_batchIndex.insert(resId, batch.startDateTime(), batch.endDateTime());
     m_batchToResMap.insert(resId, batch);
     m_resToBatchMap.insert(resId, resId);
-    storeBatch(resId, batch);
-    Q_EMIT batchAdded(resId);
+    persistBatch(resId);
+    notifyBatchChange(resId, BatchChange::Added);
     return resId;
 }
 
@@ -319,6 +523,84 @@ QString ReservationManager::addReservationWithPostProcessing(const QVariant &res
     return !l.isEmpty() ? l.at(0) : QString();
 }
 
+QList<QString> ReservationManager::addReservations(const QList<QVariant> &resData, const QStringList &resIdHints)
+{
+    QList<QString> ids;
+    ids.reserve(resData.size());
+    ReservationBulkUpdate bulkUpdate(this);
+    for (qsizetype i = 0; i < resData.size(); ++i) {
+        ids.push_back(addReservation(resData.at(i), resIdHints.value(i)));
+    }
+    return ids;
+}
+
+void ReservationManager::beginBulkUpdate()
+{
+    ++m_bulkUpdateDepth;
+}
+
+void ReservationManager::endBulkUpdate()
+{
+    Q_ASSERT(m_bulkUpdateDepth > 0);
+    if (m_bulkUpdateDepth > 1) {
+        --m_bulkUpdateDepth;
+        return;
+    }
+
+    // handlers of the per-batch signals can trigger further changes, those are
+    // still collected and processed in the next iteration
+    QStringList changedBatchIds;
+    while (!m_pendingReservations.isEmpty() || !m_pendingBatchWrites.isEmpty() || !m_pendingBatchChangeOrder.empty()) {
+        flushPendingWrites();
+
+        const auto order = std::move(m_pendingBatchChangeOrder);
+        m_pendingBatchChangeOrder.clear();
+        auto changes = std::move(m_pendingBatchChanges);
+        m_pendingBatchChanges.clear();
+        for (const auto &batchId : order) {
+            if (!changes.contains(batchId)) {
+                continue; // duplicate, or no net change
+            }
+            emitBatchChange(batchId, changes.take(batchId));
+            changedBatchIds.push_back(batchId);
+        }
+    }
+
+    m_bulkUpdateDepth = 0;
+    if (!changedBatchIds.isEmpty()) {
+        changedBatchIds.removeDuplicates();
+        Q_EMIT batchesChanged(changedBatchIds);
+    }
+}
+
+bool ReservationManager::isBulkUpdateInProgress() const
+{
+    return m_bulkUpdateDepth > 0;
+}
+
+void ReservationManager::flushPendingWrites()
+{
+    const auto pendingReservations = std::move(m_pendingReservations);
+    m_pendingReservations.clear();
+    const auto depth = std::exchange(m_bulkUpdateDepth, 0);
+    for (auto it = pendingReservations.constBegin(); it != pendingReservations.constEnd(); ++it) {
+        storeReservation(it.key(), it.value().res, it.value().isPostProcessed);
+    }
+    m_bulkUpdateDepth = depth;
+
+    const auto pendingBatches = std::move(m_pendingBatchWrites);
+    m_pendingBatchWrites.clear();
+    for (const auto &batchId : pendingBatches) {
+        if (const auto it = m_batchToResMap.constFind(batchId); it != m_batchToResMap.constEnd()) {
+            storeBatch(batchId, it.value());
+        } else {
+            storeRemoveBatch(batchId);
+        }
+    }
+    syncStores();
+    qCDebug(Log) << "bulk update written:" << pendingReservations.size() << "reservations," << pendingBatches.size() << "batches";
+}
+
 void ReservationManager::updateReservation(const QString &resId, QVariant res)
 {
     const auto oldRes = reservation(resId);
@@ -330,27 +612,91 @@ void ReservationManager::updateReservation(const QString &resId, QVariant res)
         res = postProcResult.at(0);
     }
 
-    storeReservation(resId, res);
+    storeReservation(resId, res, postProcResult.size() == 1);
     Q_EMIT reservationChanged(resId);
 
     updateBatch(resId, res, oldRes);
 }
 
-void ReservationManager::storeReservation(const QString &resId, const QVariant &res) const
+void ReservationManager::storeReservation(const QString &resId, const QVariant &res, bool isPostProcessed) const
+{
+    if (m_bulkUpdateDepth > 0) {
+        // written in flushPendingWrites(), and kept out of the cache so it can't get evicted until then
+        m_pendingReservations.insert(resId, {.res = res, .isPostProcessed = isPostProcessed});
+        m_cache.remove(resId);
+        ++m_revision;
+        return;
+    }
+
+    const auto data = writeReservationRecord(JsonLdDocument::toJson(res), isPostProcessed ? PostprocessorVersion : QLatin1StringView());
+    reservationStore().write(resId, data);
+    ++m_revision;
+    const auto endDt = SortUtil::endDateTime(res);
+    m_cache.insert(resId, res, data.size(), cachePriority(endDt.isValid() ? endDt : SortUtil::startDateTime(res)));
+}
+
+void ReservationManager::upgradeStoredReservations()
+{
+    if (!m_upgradeQueue.empty() || QSettings().value(PostprocessorVersionSettingsKey).toString() == PostprocessorVersion) {
+        return;
+    }
+
+    m_upgradeQueue = reservationStore().keys();
+    qCDebug(Log) << "Upgrading" << m_upgradeQueue.size() << "stored reservations to post-processor version" << PostprocessorVersion;
+    upgradeNextStoredReservations();
+}
+
+void ReservationManager::upgradeNextStoredReservations()
 {
-    const QString basePath = reservationsBasePath();
-    QDir::root().mkpath(basePath);
-    const QString path = basePath + resId + QLatin1StringView(".jsonld");
-    QFile f(path);
-    if (!f.open(QFile::WriteOnly)) {
-        qCWarning(Log) << "Unable to open file:" << f.errorString();
+    if (m_upgradeQueue.empty()) {
+        qCDebug(Log) << "Stored reservations upgraded to post-processor version" << PostprocessorVersion;
+        QSettings().setValue(PostprocessorVersionSettingsKey, PostprocessorVersion);
         return;
     }
-    f.write(JsonIO::write(JsonLdDocument::toJson(res)));
-    m_reservations.insert(resId, res);
+
+    struct UpgradeJob {
+        QString resId;
+        QByteArray oldData;
+        QByteArray newData;
+    };
+    std::vector<UpgradeJob> jobs;
+    jobs.reserve(UpgradeChunkSize);
+    while (jobs.size() < UpgradeChunkSize && !m_upgradeQueue.empty()) {
+        auto resId = std::move(m_upgradeQueue.back());
+        m_upgradeQueue.pop_back();
+        auto data = reservationStore().read(resId);
+        if (!data.isEmpty()) {
+            jobs.push_back({.resId = std::move(resId), .oldData = std::move(data), .newData = {}});
+        }
+    }
+
+    m_upgradeThreadPool.start([this, jobs = std::move(jobs)]() mutable {
+        for (auto &job : jobs) {
+            const auto record = readReservationRecord(job.oldData);
+            if (record.postprocessorVersion == PostprocessorVersion) {
+                continue;
+            }
+            ExtractorPostprocessor postproc;
+            postproc.process(parseReservationRecord(record));
+            if (postproc.result().size() == 1) {
+                job.newData = writeReservationRecord(JsonLdDocument::toJson(postproc.result().at(0)), PostprocessorVersion);
+            }
+        }
+
+        QMetaObject::invokeMethod(this, [this, jobs = std::move(jobs)]() {
+            auto &store = reservationStore();
+            for (const auto &job : jobs) {
+                // don't overwrite changes made in the meantime
+                if (!job.newData.isEmpty() && store.read(job.resId) == job.oldData) {
+                    store.write(job.resId, job.newData);
+                }
+            }
+            upgradeNextStoredReservations();
+        }, Qt::QueuedConnection);
+    });
 }
 
-void ReservationManager::updateBatch(const std::vector<ReservationManager::ReservationChange> &changeset)
+void ReservationManager::updateBatch(const std::vector<ReservationManager::ReservationChange> &changeset, bool isPostProcessed)
 {
     if (changeset.empty()) {
         return;
@@ -363,16 +709,14 @@ void ReservationManager::updateBatch(const std::vector<ReservationManager::Reser
             batchId = bid;
         }
         assert(batchId == bid && !batchId.isEmpty());
-        storeReservation(change.id, change.res);
+        storeReservation(change.id, change.res, isPostProcessed);
     }
 
     auto &batch = m_batchToResMap[batchId];
-    populateBatchTimes(m_batchToResMap[batchId]);
-    storeBatch(batchId, batch);
-
-    // TODO can probably be done more efficiently by only moving batchId
-    std::ranges::sort(m_batches, BatchComparator(this));
-    Q_EMIT batchContentChanged(batchId);
+    populateBatchTimes(batch);
+    m_batchIndex.update(batchId, batch.startDateTime(), batch.endDateTime());
+    persistBatch(batchId);
+    notifyBatchChange(batchId, BatchChange::ContentChanged);
 }
 
 void ReservationManager::removeReservation(const QString &id)
@@ -380,17 +724,31 @@ void ReservationManager::removeReservation(const QString &id)
     const auto batchId = m_resToBatchMap.value(id);
     removeFromBatch(id, batchId);
 
-    const QString basePath = reservationsBasePath();
-    if (!QFile::remove(basePath + '/'_L1 + id + ".jsonld"_L1)) {
-        qCWarning(Log) << "Failed to remove file:" << id;
+    m_pendingReservations.remove(id);
+    reservationStore().remove(id);
+    if (!isBulkUpdateInProgress()) {
+        syncStores();
     }
+    ++m_revision;
+    // legacy storage, in case this hasn't been migrated yet
+    QFile::remove(reservationsBasePath() + id + ".jsonld"_L1);
     Q_EMIT reservationRemoved(id);
-    m_reservations.remove(id);
+    m_cache.remove(id);
 }
 
 const std::vector<QString> &ReservationManager::batches() const
 {
-    return m_batches;
+    return m_batchIndex.batchIds();
+}
+
+qsizetype ReservationManager::indexOfBatch(const QString &batchId) const
+{
+    return m_batchIndex.indexOf(batchId);
+}
+
+std::vector<QString> ReservationManager::batchesInRange(const QDateTime &begin, const QDateTime &end) const
+{
+    return m_batchIndex.overlapping(begin, end);
 }
 
 QString ReservationManager::batchForReservation(const QString &resId) const
@@ -417,28 +775,24 @@ void ReservationManager::removeBatch(const QString &batchId)
 
 void ReservationManager::loadBatches()
 {
-    Q_ASSERT(m_batches.empty());
+    StartupTrace::Phase tracePhase("ReservationManager::loadBatches");
+    Q_ASSERT(m_batchIndex.size() == 0);
 
-    const auto base = batchesBasePath();
-    if (!QDir::root().exists(base)) {
-        initialBatchCreate();
-        return;
+    if (!QFile::exists(batchesStorePath())) {
+        if (!QDir::root().exists(batchesBasePath())) {
+            initialBatchCreate();
+            return;
+        }
+        // legacy one file per batch storage, not migrated yet
+        importBatchFiles(batchesBasePath());
     }
 
     QStringList batchesToRemove; // broken stuff detected during loading
 
-    for (QDirIterator it(base, QDir::NoDotAndDotDot | QDir::Files); it.hasNext();) {
-        it.next();
-        QFile batchFile(it.filePath());
-        if (!batchFile.open(QFile::ReadOnly)) {
-            qCWarning(Log) << "Failed to open batch file" << it.filePath() << batchFile.errorString();
-            continue;
-        }
-
-        const auto batchId = it.fileInfo().baseName();
-        m_batches.push_back(batchId);
-
-        const auto batch = ReservationBatch::fromJson(JsonIO::read(batchFile.readAll()).toObject());
+    const auto records = batchStore().readAll();
+    m_batchToResMap.reserve(records.size());
+    for (const auto &[batchId, data] : records) {
+        const auto batch = ReservationBatch::fromJson(JsonIO::read(data).toObject());
         if (batch.reservationIds().isEmpty()) {
             batchesToRemove.push_back(batchId);
             continue;
@@ -451,14 +805,15 @@ void ReservationManager::loadBatches()
     }
 
     // populate batch times where they are missing, e.g. for legacy app data
+    m_batchIndex.reserve(m_batchToResMap.size());
     for (auto it = m_batchToResMap.begin(); it != m_batchToResMap.end(); ++it) {
         if (!it.value().startDateTime().isValid()) {
             populateBatchTimes(it.value());
             storeBatch(it.key(), it.value());
         }
+        m_batchIndex.append(it.key(), it.value().startDateTime(), it.value().endDateTime());
     }
-
-    std::ranges::sort(m_batches, BatchComparator(this));
+    m_batchIndex.sort();
 
     for (const auto &batchId : batchesToRemove) {
         storeRemoveBatch(batchId);
@@ -467,40 +822,185 @@ void ReservationManager::loadBatches()
 
 void ReservationManager::storeBatch(const QString &batchId, const ReservationBatch &batch)
 {
-    const QString path = batchesBasePath() + batchId + ".json"_L1;
-    QFile f(path);
-    if (!f.open(QFile::WriteOnly | QFile::Truncate)) {
-        qCWarning(Log) << "Failed to open batch file!" << path << f.errorString();
+    batchStore().write(batchId, JsonIO::write(batch.toJson()));
+}
+
+void ReservationManager::storeRemoveBatch(const QString &batchId)
+{
+    batchStore().remove(batchId);
+}
+
+void ReservationManager::persistBatch(const QString &batchId)
+{
+    if (m_bulkUpdateDepth > 0) {
+        m_pendingBatchWrites.insert(batchId);
         return;
     }
 
-    f.write(JsonIO::write(batch.toJson()));
+    if (const auto it = m_batchToResMap.constFind(batchId); it != m_batchToResMap.constEnd()) {
+        storeBatch(batchId, it.value());
+    } else {
+        storeRemoveBatch(batchId);
+    }
+    // every change outside of bulk updates ends here, see flushPendingWrites() for bulk updates
+    syncStores();
 }
 
-void ReservationManager::storeRemoveBatch(const QString &batchId)
+void ReservationManager::notifyBatchChange(const QString &batchId, BatchChange change)
 {
-    const QString path = batchesBasePath() + batchId + ".json"_L1;
-    if (!QFile::remove(path)) {
-        qCWarning(Log) << "Failed to remove file:" << path;
+    if (m_bulkUpdateDepth == 0) {
+        emitBatchChange(batchId, change);
+        return;
     }
+
+    const auto it = m_pendingBatchChanges.find(batchId);
+    if (it == m_pendingBatchChanges.end()) {
+        m_pendingBatchChanges.insert(batchId, change);
+        m_pendingBatchChangeOrder.push_back(batchId);
+        return;
+    }
+
+    // merge with the previous change, so only the net effect is notified
+    switch (it.value()) {
+    case BatchChange::Added:
+        if (change == BatchChange::Removed) {
+            m_pendingBatchChanges.erase(it);
+        }
+        break;
+    case BatchChange::Removed:
+        if (change == BatchChange::Added) {
+            it.value() = BatchChange::ContentChanged;
+        }
+        break;
+    case BatchChange::Changed:
+    case BatchChange::ContentChanged:
+        if (change == BatchChange::Removed) {
+            it.value() = BatchChange::Removed;
+        } else if (change != it.value()) {
+            it.value() = BatchChange::ContentChanged;
+        }
+        break;
+    }
+}
+
+void ReservationManager::notifyBatchRenamed(const QString &oldBatchId, const QString &newBatchId)
+{
+    if (m_bulkUpdateDepth > 0) {
+        if (const auto it = m_pendingBatchChanges.constFind(oldBatchId); it != m_pendingBatchChanges.constEnd()) {
+            const auto change = it.value();
+            m_pendingBatchChanges.erase(it);
+            if (change == BatchChange::Added) {
+                // nobody has seen the old batch yet, so this is just a different new batch
+                notifyBatchChange(newBatchId, BatchChange::Added);
+                return;
+            }
+            Q_EMIT batchRenamed(oldBatchId, newBatchId);
+            notifyBatchChange(newBatchId, change);
+            return;
+        }
+    }
+    Q_EMIT batchRenamed(oldBatchId, newBatchId);
+}
+
+void ReservationManager::emitBatchChange(const QString &batchId, BatchChange change)
+{
+    switch (change) {
+    case BatchChange::Added:
+        Q_EMIT batchAdded(batchId);
+        break;
+    case BatchChange::Changed:
+        Q_EMIT batchChanged(batchId);
+        break;
+    case BatchChange::ContentChanged:
+        Q_EMIT batchContentChanged(batchId);
+        break;
+    case BatchChange::Removed:
+        Q_EMIT batchRemoved(batchId);
+        break;
+    }
+}
+
+int ReservationManager::importBatchFiles(const QString &path)
+{
+    int count = 0;
+    auto &store = batchStore();
+    for (QDirIterator it(path, {u"*.json"_s}, QDir::Files); it.hasNext();) {
+        it.next();
+        QFile f(it.filePath());
+        if (!f.open(QFile::ReadOnly)) {
+            qCWarning(Log) << "Failed to open batch file" << f.fileName() << f.errorString();
+            continue;
+        }
+        store.write(it.fileInfo().baseName(), JsonIO::convert(f.readAll(), JsonIO::CBOR));
+        ++count;
+    }
+    return count;
 }
 
 void ReservationManager::initialBatchCreate()
 {
-    const auto batchBase = batchesBasePath();
-    QDir::root().mkpath(batchBase);
-    qCDebug(Log) << batchBase;
+    // creates the batch store file, so we don't end up here again even without any reservations
+    [[maybe_unused]] const auto &store = batchStore();
 
     const QSignalBlocker blocker(this);
-    const auto base = reservationsBasePath();
-    for (QDirIterator it(base, QDir::NoDotAndDotDot | QDir::Files); it.hasNext();) {
+    auto resIds = reservationStore().keys();
+    for (QDirIterator it(reservationsBasePath(), {u"*.jsonld"_s}, QDir::Files); it.hasNext();) {
         it.next();
-        const auto resId = it.fileInfo().baseName();
+        resIds.push_back(it.fileInfo().baseName());
+    }
+    std::ranges::sort(resIds);
+    resIds.erase(std::unique(resIds.begin(), resIds.end()), resIds.end());
+
+    for (const auto &resId : resIds) {
         const auto res = reservation(resId);
         updateBatch(resId, res, res);
     }
 }
 
+int ReservationManager::importReservationFiles(const QString &path)
+{
+    int count = 0;
+    auto &store = reservationStore();
+    for (QDirIterator it(path, {u"*.jsonld"_s}, QDir::Files); it.hasNext();) {
+        it.next();
+        QFile f(it.filePath());
+        if (!f.open(QFile::ReadOnly)) {
+            qCWarning(Log) << "Failed to open JSON-LD reservation data file:" << f.fileName() << f.errorString();
+            continue;
+        }
+        const auto val = JsonIO::read(f.readAll());
+        if (!val.isObject() && !val.isArray()) {
+            qCWarning(Log) << "Invalid JSON-LD reservation data file:" << f.fileName();
+            continue;
+        }
+        store.write(it.fileInfo().baseName(), writeReservationRecord(val, {}));
+        ++count;
+    }
+    return count;
+}
+
+int ReservationManager::exportReservationFiles(const QString &path)
+{
+    QDir().mkpath(path);
+    int count = 0;
+    const auto &store = reservationStore();
+    for (const auto &resId : store.keys()) {
+        QFile f(path + '/'_L1 + resId + ".jsonld"_L1);
+        if (!f.open(QFile::WriteOnly | QFile::Truncate)) {
+            qCWarning(Log) << "Failed to open JSON-LD reservation data file:" << f.fileName() << f.errorString();
+            continue;
+        }
+        f.write(JsonIO::write(readReservationRecord(store.read(resId)).data));
+        ++count;
+    }
+    return count;
+}
+
+bool ReservationManager::isPostProcessed(const QString &resId)
+{
+    return readReservationRecord(reservationStore().read(resId)).postprocessorVersion == PostprocessorVersion;
+}
+
 void ReservationManager::populateBatchTimes(ReservationBatch &batch) const
 {
     for (const auto &resId : batch.reservationIds()) {
@@ -528,28 +1028,29 @@ void ReservationManager::updateBatch(const QString &resId, const QVariant &newRe
     bool sortOrderInvalid = false;
     const auto oldBatchId = batchForReservation(resId);
     if (oldBatchId == resId) {
-        const auto it = std::find(m_batches.begin(), m_batches.end(), resId);
-        if (it != m_batches.begin() && it != m_batches.end()) {
-            sortOrderInvalid |= reservationIsBefore(reservation(*it), reservation(*std::prev(it)));
+        const auto &batchIds = m_batchIndex.batchIds();
+        const auto idx = m_batchIndex.indexOf(resId);
+        if (idx > 0) {
+            sortOrderInvalid |= reservationIsBefore(reservation(batchIds[idx]), reservation(batchIds[idx - 1]));
         }
-        if (it != m_batches.end() && std::distance(it, m_batches.end()) > 1) {
-            sortOrderInvalid |= reservationIsBefore(reservation(*std::next(it)), reservation(*it));
+        if (idx >= 0 && idx + 1 < m_batchIndex.size()) {
+            sortOrderInvalid |= reservationIsBefore(reservation(batchIds[idx + 1]), reservation(batchIds[idx]));
         }
-        if (sortOrderInvalid) { // otherwise the lower_bound search below doesn't work!
+        if (sortOrderInvalid) { // otherwise the lower bound search below doesn't work!
             removeFromBatch(resId, oldBatchId);
         }
     }
     QString newBatchId;
 
     // find the destination batch
-    const auto beginIt = std::lower_bound(m_batches.begin(), m_batches.end(), SortUtil::startDateTime(newRes), BatchComparator(this));
-    for (auto it = beginIt; it != m_batches.end(); ++it) {
-        const auto otherRes = (resId == (*it)) ? oldRes : reservation(*it);
+    for (auto i = m_batchIndex.lowerBound(SortUtil::startDateTime(newRes)); i < m_batchIndex.size(); ++i) {
+        const auto &batchId = m_batchIndex.batchIds()[i];
+        const auto otherRes = (resId == batchId) ? oldRes : reservation(batchId);
         if (!DateTimeHelper::isSameDateTime(SortUtil::startDateTime(otherRes), SortUtil::startDateTime(newRes))) {
             break; // no hit
         }
         if (MergeUtil::isSameIncidence(newRes, otherRes)) {
-            newBatchId = *it;
+            newBatchId = batchId;
             break;
         }
     }
@@ -558,13 +1059,13 @@ void ReservationManager::updateBatch(const QString &resId, const QVariant &newRe
     if (!oldBatchId.isEmpty() && oldBatchId == newBatchId) {
         auto &batch = m_batchToResMap[newBatchId];
         populateBatchTimes(batch);
-        storeBatch(newBatchId, batch);
-        Q_EMIT batchContentChanged(oldBatchId);
+        m_batchIndex.update(newBatchId, batch.startDateTime(), batch.endDateTime());
+        persistBatch(newBatchId);
+        notifyBatchChange(oldBatchId, BatchChange::ContentChanged);
         return;
     }
 
     // move us out of the old batch
-    // WARNING: beginIt will become invalid after this!
     if (!sortOrderInvalid) {
         removeFromBatch(resId, oldBatchId);
     }
@@ -572,23 +1073,22 @@ void ReservationManager::updateBatch(const QString &resId, const QVariant &newRe
     // insert us into the new batch
     if (newBatchId.isEmpty()) {
         // we are starting a new batch
-        // re-run search for insertion point, could be invalid due to the above deletions
-        const auto it = std::lower_bound(m_batches.begin(), m_batches.end(), SortUtil::startDateTime(newRes), BatchComparator(this));
-        m_batches.insert(it, QString(resId));
         ReservationBatch batch;
         batch.m_resIds = {resId};
         populateBatchTimes(batch);
+        m_batchIndex.insert(resId, batch.startDateTime(), batch.endDateTime());
         m_batchToResMap.insert(resId, batch);
         m_resToBatchMap.insert(resId, resId);
-        Q_EMIT batchAdded(resId);
-        storeBatch(resId, batch);
+        notifyBatchChange(resId, BatchChange::Added);
+        persistBatch(resId);
     } else {
         auto &batch = m_batchToResMap[newBatchId];
         batch.m_resIds.push_back(resId);
         populateBatchTimes(batch);
+        m_batchIndex.update(newBatchId, batch.startDateTime(), batch.endDateTime());
         m_resToBatchMap.insert(resId, newBatchId);
-        Q_EMIT batchChanged(newBatchId);
-        storeBatch(newBatchId, batch);
+        notifyBatchChange(newBatchId, BatchChange::Changed);
+        persistBatch(newBatchId);
     }
 }
 
@@ -602,30 +1102,28 @@ void ReservationManager::removeFromBatch(const QString &resId, const QString &ba
     m_resToBatchMap.remove(resId);
     if (batch.reservationIds().size() == 1) { // we were alone there, remove old batch
         m_batchToResMap.remove(batchId);
-        const auto it = std::find(m_batches.begin(), m_batches.end(), batchId);
-        m_batches.erase(it);
-        Q_EMIT batchRemoved(batchId);
-        storeRemoveBatch(batchId);
+        m_batchIndex.remove(batchId);
+        notifyBatchChange(batchId, BatchChange::Removed);
+        persistBatch(batchId);
     } else if (resId == batchId) {
         // our id was the batch id, so rename the old batch
         batch.m_resIds.removeAll(resId);
         const QString renamedBatchId = batch.reservationIds().first();
-        auto it = std::find(m_batches.begin(), m_batches.end(), batchId);
-        Q_ASSERT(it != m_batches.end());
-        *it = renamedBatchId;
+        Q_ASSERT(m_batchIndex.contains(batchId));
+        m_batchIndex.rename(batchId, renamedBatchId);
         for (const auto &id : batch.reservationIds()) {
             m_resToBatchMap[id] = renamedBatchId;
         }
         m_batchToResMap[renamedBatchId] = batch;
         m_batchToResMap.remove(batchId);
-        Q_EMIT batchRenamed(batchId, renamedBatchId);
-        storeRemoveBatch(batchId);
-        storeBatch(renamedBatchId, batch);
+        notifyBatchRenamed(batchId, renamedBatchId);
+        persistBatch(batchId);
+        persistBatch(renamedBatchId);
     } else {
         // old batch remains
         batch.m_resIds.removeAll(resId);
-        Q_EMIT batchChanged(batchId);
-        storeBatch(batchId, batch);
+        notifyBatchChange(batchId, BatchChange::Changed);
+        persistBatch(batchId);
     }
 }
 
@@ -645,9 +1143,9 @@ QVariant ReservationManager::isPartialUpdate(const QVariant &res) const
     const auto rangeBegin = baseRes.modifiedTime();
     const auto rangeEnd = rangeBegin.addDays(6 * 30);
 
-    const auto beginIt = std::lower_bound(m_batches.begin(), m_batches.end(), rangeBegin, BatchComparator(this));
-    for (auto it = beginIt; it != m_batches.end(); ++it) {
-        auto otherRes = reservation(*it);
+    for (auto i = m_batchIndex.lowerBound(rangeBegin); i < m_batchIndex.size(); ++i) {
+        const auto &batchId = m_batchIndex.batchIds()[i];
+        auto otherRes = reservation(batchId);
         if (SortUtil::startDateTime(otherRes) > rangeEnd) {
             break; // no hit
         }
@@ -656,7 +1154,7 @@ QVariant ReservationManager::isPartialUpdate(const QVariant &res) const
         }
         if (MergeUtil::isSameIncidence(res, otherRes)) {
             // this is a multi-traveler element, check if we have it as one of the batch elements
-            const auto &batch = m_batchToResMap.value(*it);
+            const auto &batch = m_batchToResMap.value(batchId);
             for (const auto &batchedId : batch.reservationIds()) {
                 auto batchedRes = reservation(batchedId);
                 if (MergeUtil::isSame(res, batchedRes)) {
@@ -686,23 +1184,24 @@ QList<QString> ReservationManager::applyPartialUpdate(const QVariant &res)
     const auto rangeEnd = rangeBegin.addDays(6 * 30);
 
     QList<QString> updatedIds;
-    const auto beginIt = std::lower_bound(m_batches.begin(), m_batches.end(), rangeBegin, BatchComparator(this));
-    for (auto it = beginIt; it != m_batches.end(); ++it) {
-        const auto otherRes = reservation(*it);
+    for (auto i = m_batchIndex.lowerBound(rangeBegin); i < m_batchIndex.size(); ++i) {
+        // copy, updateReservation() below can modify the batch index
+        const auto batchId = m_batchIndex.batchIds()[i];
+        const auto otherRes = reservation(batchId);
         if (SortUtil::startDateTime(otherRes) > rangeEnd) {
             break; // no hit
         }
         if (MergeUtil::isSame(res, otherRes)) {
             // this is actually an update of otherRes!
             const auto newRes = MergeUtil::merge(otherRes, res);
-            updateReservation(*it, newRes);
-            updatedIds.push_back(*it);
+            updateReservation(batchId, newRes);
+            updatedIds.push_back(batchId);
             continue;
         }
         if (MergeUtil::isSameIncidence(res, otherRes)) {
             // this is a multi-traveler element, check if we have it as one of the
             // batch elements already
-            const auto &batch = m_batchToResMap.value(*it);
+            const auto batch = m_batchToResMap.value(batchId);
             for (const auto &batchedId : batch.reservationIds()) {
                 const auto batchedRes = reservation(batchedId);
                 if (MergeUtil::isSame(res, batchedRes)) {
@@ -726,22 +1225,12 @@ ReservationBatch ReservationManager::batch(const QString &batchId) const
 
 QString ReservationManager::previousBatch(const QString &batchId) const
 {
-    // ### this can be optimized by relying on m_batches being sorted by start date
-    const auto it = std::find(m_batches.begin(), m_batches.end(), batchId);
-    if (it == m_batches.end() || it == m_batches.begin()) {
-        return {};
-    }
-    return *(it - 1);
+    return m_batchIndex.previous(batchId);
 }
 
 QString ReservationManager::nextBatch(const QString &batchId) const
 {
-    // ### this can be optimized by relying on m_batches being sorted by start date
-    const auto it = std::find(m_batches.begin(), m_batches.end(), batchId);
-    if (it == m_batches.end() || m_batches.size() < 2 || it == (m_batches.end() - 1)) {
-        return {};
-    }
-    return *(it + 1);
+    return m_batchIndex.next(batchId);
 }
 
 QString ReservationManager::makeReservationId(const QString &resIdHint) const
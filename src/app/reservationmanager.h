@@ -7,11 +7,16 @@
 #ifndef RESERVATIONMANAGER_H
 #define RESERVATIONMANAGER_H
 
+#include "batchindex.h"
+#include "reservationcache.h"
+
 #include <KItinerary/ExtractorValidator>
 
 #include <QDateTime>
 #include <QHash>
 #include <QObject>
+#include <QSet>
+#include <QThreadPool>
 #include <QVariant>
 
 class ReservationManager;
@@ -86,15 +91,41 @@ public:
      */
     QList<QString> addReservationsWithPostProcessing(const QList<QVariant> &resData);
     Q_INVOKABLE QString addReservationWithPostProcessing(const QVariant &resData);
+    /** Adds multiple reservations at once.
+     *  Same as calling addReservation() for each element, but as one bulk update.
+     *  @param resIdHints Optional identifier hints, in the same order as @p resData.
+     *  @returns The ids of the new or merged reservations, in the same order as @p resData.
+     *  Elements that were discarded have an empty id.
+     */
+    QList<QString> addReservations(const QList<QVariant> &resData, const QStringList &resIdHints = {});
+
+    /** Begin/end a bulk update, e.g. for importing a large amount of data.
+     *  Until the (outermost) bulk update ends storage writes are deferred and
+     *  batch change notifications are coalesced, so each affected batch is only
+     *  notified once, followed by batchesChanged().
+     *  Prefer ReservationBulkUpdate over calling this directly.
+     */
+    void beginBulkUpdate();
+    void endBulkUpdate();
+    [[nodiscard]] bool isBulkUpdateInProgress() const;
 
     struct ReservationChange {
         QString id;
         QVariant res;
     };
-    /** Update an entire batch, without attempting re-batching. */
-    void updateBatch(const std::vector<ReservationChange> &changeset);
+    /** Update an entire batch, without attempting re-batching.
+     *  @param isPostProcessed @c true if the changes are derived from post-processed reservations
+     *  of this instance (such as live data updates), so they don't need post-processing again.
+     */
+    void updateBatch(const std::vector<ReservationChange> &changeset, bool isPostProcessed);
 
     const std::vector<QString> &batches() const;
+    /** Position of @p batchId in batches(), or -1 if there is no such batch. */
+    [[nodiscard]] qsizetype indexOfBatch(const QString &batchId) const;
+    /** Returns all batches overlapping with the time range [@p begin, @p end], in order.
+     *  An invalid @p end means the range is open-ended.
+     */
+    [[nodiscard]] std::vector<QString> batchesInRange(const QDateTime &begin, const QDateTime &end) const;
     bool hasBatch(const QString &batchId) const;
     QString batchForReservation(const QString &resId) const;
     Q_INVOKABLE QStringList reservationsForBatch(const QString &batchId) const;
@@ -107,6 +138,25 @@ public:
     /** Returns the batch happening after @p batchId, if any. */
     QString nextBatch(const QString &batchId) const;
 
+    /** Re-run post-processing on stored reservations that were processed
+     *  by a different KItinerary version.
+     *  This happens incrementally in the background, reservations that are loaded
+     *  before that are post-processed on demand.
+     */
+    void upgradeStoredReservations();
+
+    /** Load the reservations of @p batchIds asynchronously.
+     *  Decoding happens in parallel on a worker thread pool, batchesLoaded() is
+     *  emitted once done. Use this to prefetch reservations that are about to be
+     *  needed, reservation() will then not need to block on loading them.
+     */
+    void loadBatchesAsync(const QStringList &batchIds);
+
+    /** Memory budget for the deserialized reservation cache. */
+    void setCacheBudget(qsizetype budget);
+    /** Reservation cache hit/miss/eviction statistics. */
+    [[nodiscard]] ReservationCache::Statistics cacheStatistics() const;
+
     /** Validator configured to accept all supported reservation types. */
     [[nodiscard]] static KItinerary::ExtractorValidator validator();
 
@@ -115,11 +165,36 @@ public:
 
     /* Storage locations of reservations and batches
      * Do not use directly, apart from special cases like Migrator.
+     * reservationsBasePath() is the legacy one file per reservation storage,
+     * reservationsStorePath() the single file record store replacing that.
+     * The same applies to batchesBasePath() and batchesStorePath().
      */
     static QString reservationsBasePath();
+    static QString reservationsStorePath();
     static QString batchesBasePath();
+    static QString batchesStorePath();
     static void storeBatch(const QString &batchId, const ReservationBatch &batch);
 
+    /** Import reservations stored in the legacy one JSON-LD file per reservation
+     *  layout in @p path into the reservation store.
+     *  This does not update batches, only use this before creating a ReservationManager instance.
+     *  @returns The number of imported reservations.
+     */
+    static int importReservationFiles(const QString &path);
+    /** Import batches stored in the legacy one JSON file per batch layout in @p path.
+     *  Only use this before creating a ReservationManager instance.
+     *  @returns The number of imported batches.
+     */
+    static int importBatchFiles(const QString &path);
+    /** Export all stored reservations to @p path in the one JSON-LD file per reservation layout.
+     *  @returns The number of exported reservations.
+     */
+    static int exportReservationFiles(const QString &path);
+    /** Checks whether the stored data of @p resId has been post-processed with the current KItinerary version.
+     *  @internal For unit tests only.
+     */
+    [[nodiscard]] static bool isPostProcessed(const QString &resId);
+
     /** Recompute batch times.
      *  For internal use only, do not use directly, apart from special cases like Migrator.
      */
@@ -145,21 +220,24 @@ Q_SIGNALS:
     void batchRenamed(const QString &oldBatchId, const QString &newBatchId);
     void batchRemoved(const QString &batchId);
 
+    /** Emitted at the end of a bulk update, with all batches added, changed or removed during it.
+     *  Per-batch signals for those are emitted right before, while isBulkUpdateInProgress()
+     *  is still true. Consumers that do expensive global updates on batch changes can skip
+     *  those and only handle this instead.
+     */
+    void batchesChanged(const QStringList &batchIds);
+
+    /** Emitted once loading batches requested by loadBatchesAsync() is complete. */
+    void batchesLoaded(const QStringList &batchIds);
+
 private:
-    void loadReservation(const QString &resId) const;
-    void loadReservationsInBatch(const QString &batchId) const;
-    void storeReservation(const QString &resId, const QVariant &res) const;
-
-    struct BatchComparator {
-        BatchComparator(const ReservationManager *resMgr)
-            : m_resMgr(resMgr)
-        {
-        }
-        [[nodiscard]] bool operator()(const QString &lhs, const QString &rhs) const;
-        [[nodiscard]] bool operator()(const QString &lhs, const QDateTime &rhs) const;
-        [[nodiscard]] bool operator()(const QDateTime &lhs, const QString &rhs) const;
-        const ReservationManager *m_resMgr;
-    };
+    [[nodiscard]] QVariant loadReservation(const QString &resId) const;
+    QHash<QString, QVariant> loadReservationsInBatch(const QString &batchId) const;
+    QHash<QString, QVariant> cacheBatch(const ReservationBatch &batch, QHash<QString, QVariant> &&reservations) const;
+    void storeReservation(const QString &resId, const QVariant &res, bool isPostProcessed = false) const;
+    /** addReservation() implementation, @p isPostProcessed is passed on to storeReservation(). */
+    QString addReservation(const QVariant &res, const QString &resIdHint, bool isPostProcessed);
+    void upgradeNextStoredReservations();
 
     void loadBatches();
     void initialBatchCreate();
@@ -167,18 +245,68 @@ private:
 
     void updateBatch(const QString &resId, const QVariant &newRes, const QVariant &oldRes);
     void removeFromBatch(const QString &resId, const QString &batchId);
+    /** Write the current state of @p batchId to storage, or remove it from there if it no longer exists. */
+    void persistBatch(const QString &batchId);
+
+    enum class BatchChange {
+        Added,
+        Changed,
+        ContentChanged,
+        Removed,
+    };
+    void notifyBatchChange(const QString &batchId, BatchChange change);
+    void notifyBatchRenamed(const QString &oldBatchId, const QString &newBatchId);
+    void emitBatchChange(const QString &batchId, BatchChange change);
+    void flushPendingWrites();
 
     QString makeReservationId(const QString &resIdHint) const;
 
     QList<QString> applyPartialUpdate(const QVariant &res);
 
-    mutable QHash<QString, QVariant> m_reservations;
+    mutable ReservationCache m_cache;
+    mutable quint64 m_revision = 0; // for detecting changes during asynchronous loading
+    QThreadPool m_loadThreadPool;
 
     KItinerary::ExtractorValidator m_validator;
 
-    std::vector<QString> m_batches;
+    std::vector<QString> m_upgradeQueue;
+    QThreadPool m_upgradeThreadPool;
+
+    int m_bulkUpdateDepth = 0;
+    struct PendingReservation {
+        QVariant res;
+        bool isPostProcessed = false;
+    };
+    mutable QHash<QString, PendingReservation> m_pendingReservations;
+    QSet<QString> m_pendingBatchWrites;
+    QHash<QString, BatchChange> m_pendingBatchChanges;
+    std::vector<QString> m_pendingBatchChangeOrder;
+
+    BatchIndex m_batchIndex;
     QHash<QString, ReservationBatch> m_batchToResMap;
     QHash<QString, QString> m_resToBatchMap;
 };
 
+/** RAII wrapper for ReservationManager bulk updates. */
+class ReservationBulkUpdate
+{
+public:
+    explicit ReservationBulkUpdate(ReservationManager *resMgr)
+        : m_resMgr(resMgr)
+    {
+        if (m_resMgr) {
+            m_resMgr->beginBulkUpdate();
+        }
+    }
+    ~ReservationBulkUpdate()
+    {
+        if (m_resMgr) {
+            m_resMgr->endBulkUpdate();
+        }
+    }
+
+private:
+    ReservationManager *m_resMgr = nullptr;
+};
+
 #endif // RESERVATIONMANAGER_H
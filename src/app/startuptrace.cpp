@@ -0,0 +1,154 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "startuptrace.h"
+#include "logging.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <vector>
+
+using namespace Qt::Literals;
+
+namespace
+{
+struct TraceEvent {
+    const char *name = nullptr;
+    qint64 begin = 0; // µs
+    qint64 end = -1; // µs, -1 while still running
+    qint64 heapBegin = 0;
+    qint64 heapEnd = 0;
+};
+
+struct TraceState {
+    bool enabled = qEnvironmentVariableIsSet("ITINERARY_STARTUP_TRACE");
+    bool finished = false;
+    QElapsedTimer timer;
+    std::vector<TraceEvent> events;
+    int currentMark = -1;
+};
+}
+
+[[nodiscard]] static TraceState &traceState()
+{
+    static TraceState s;
+    return s;
+}
+
+[[nodiscard]] static bool isRecording()
+{
+    const auto &s = traceState();
+    return s.enabled && !s.finished;
+}
+
+// currently allocated heap memory, in bytes
+[[nodiscard]] static qint64 heapSize()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const auto mi = mallinfo2();
+    return (qint64)(mi.uordblks + mi.hblkhd);
+#else
+    return 0;
+#endif
+}
+
+[[nodiscard]] static int beginEvent(const char *name)
+{
+    auto &s = traceState();
+    if (!s.timer.isValid()) {
+        s.timer.start();
+    }
+    s.events.push_back({.name = name, .begin = s.timer.nsecsElapsed() / 1000, .heapBegin = heapSize()});
+    return (int)s.events.size() - 1;
+}
+
+static void endEvent(int index)
+{
+    auto &s = traceState();
+    if (index < 0 || index >= (int)s.events.size()) {
+        return;
+    }
+    auto &ev = s.events[index];
+    ev.end = s.timer.nsecsElapsed() / 1000;
+    ev.heapEnd = heapSize();
+}
+
+bool StartupTrace::isEnabled()
+{
+    return traceState().enabled;
+}
+
+void StartupTrace::mark(const char *name)
+{
+    if (!isRecording()) {
+        return;
+    }
+    auto &s = traceState();
+    endEvent(s.currentMark);
+    s.currentMark = beginEvent(name);
+}
+
+void StartupTrace::finish()
+{
+    if (!isRecording()) {
+        return;
+    }
+    auto &s = traceState();
+    endEvent(s.currentMark);
+    s.finished = true;
+
+    QJsonArray traceEvents;
+    for (const auto &ev : s.events) {
+        if (ev.end < 0) {
+            continue;
+        }
+        traceEvents.push_back(QJsonObject{
+            {"name"_L1, QString::fromUtf8(ev.name)},
+            {"cat"_L1, "startup"_L1},
+            {"ph"_L1, "X"_L1},
+            {"ts"_L1, ev.begin},
+            {"dur"_L1, ev.end - ev.begin},
+            {"pid"_L1, QCoreApplication::applicationPid()},
+            {"tid"_L1, 1},
+            {"args"_L1, QJsonObject{{"heapDelta"_L1, ev.heapEnd - ev.heapBegin}}},
+        });
+        qCInfo(Log) << "startup phase" << ev.name << (ev.end - ev.begin) / 1000.0 << "ms," << (ev.heapEnd - ev.heapBegin) / 1024 << "kB";
+    }
+
+    const QJsonObject trace{
+        {"traceEvents"_L1, traceEvents},
+        {"displayTimeUnit"_L1, "ms"_L1},
+    };
+
+    QFile f(qEnvironmentVariable("ITINERARY_STARTUP_TRACE"));
+    if (!f.open(QFile::WriteOnly)) {
+        qCWarning(Log) << "Failed to write startup trace:" << f.fileName() << f.errorString();
+        return;
+    }
+    f.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+}
+
+StartupTrace::Phase::Phase(const char *name)
+{
+    if (isRecording()) {
+        m_index = beginEvent(name);
+    }
+}
+
+StartupTrace::Phase::~Phase()
+{
+    if (m_index >= 0 && isRecording()) {
+        endEvent(m_index);
+    }
+}
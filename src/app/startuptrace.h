@@ -0,0 +1,43 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+/** Application startup tracing.
+ *  Enabled by setting the ITINERARY_STARTUP_TRACE environment variable to the
+ *  file the trace should be written to. The trace is in Chrome's trace event format,
+ *  and can be viewed e.g. with Perfetto or chrome://tracing.
+ *
+ *  For each phase this records wall time and the change in allocated heap memory.
+ *  All of this is a no-op when not enabled, and must only be used from the main thread.
+ */
+namespace StartupTrace
+{
+[[nodiscard]] bool isEnabled();
+
+/** Ends the current top-level phase (if any) and starts a new one named @p name.
+ *  Meant for sequential startup code where scoping with Phase is not possible.
+ */
+void mark(const char *name);
+
+/** Ends the current top-level phase and writes the trace file.
+ *  Further phases are not recorded after this.
+ */
+void finish();
+
+/** Scoped phase, for recording nested phases. */
+class Phase
+{
+public:
+    explicit Phase(const char *name);
+    ~Phase();
+
+private:
+    int m_index = -1;
+};
+}
+
+#endif // STARTUPTRACE_H
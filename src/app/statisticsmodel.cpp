@@ -57,9 +57,10 @@ void StatisticsModel::setReservationManager(ReservationManager *resMgr)
         return;
     }
     m_resMgr = resMgr;
-    connect(m_resMgr, &ReservationManager::batchAdded, this, &StatisticsModel::recompute);
-    connect(m_resMgr, &ReservationManager::batchContentChanged, this, &StatisticsModel::recompute);
-    connect(m_resMgr, &ReservationManager::batchRemoved, this, &StatisticsModel::recompute);
+    connect(m_resMgr, &ReservationManager::batchAdded, this, &StatisticsModel::batchChanged);
+    connect(m_resMgr, &ReservationManager::batchContentChanged, this, &StatisticsModel::batchChanged);
+    connect(m_resMgr, &ReservationManager::batchRemoved, this, &StatisticsModel::batchChanged);
+    connect(m_resMgr, &ReservationManager::batchesChanged, this, &StatisticsModel::recompute);
     Q_EMIT setupChanged();
 }
 
@@ -97,6 +98,14 @@ void StatisticsModel::setTimeRange(const QDate &begin, const QDate &end)
     recompute();
 }
 
+void StatisticsModel::batchChanged()
+{
+    // bulk updates are handled once at the end via batchesChanged()
+    if (!m_resMgr->isBulkUpdateInProgress()) {
+        recompute();
+    }
+}
+
 StatisticsItem StatisticsModel::totalCount() const
 {
     return StatisticsItem(i18n("Trips"), QLocale().toString(m_tripGroupCount), trend(m_tripGroupCount, m_prevTripGroupCount));
@@ -130,6 +130,7 @@ Q_SIGNALS:
 
 private:
     void recompute();
+    void batchChanged();
     [[nodiscard]] bool isRelevantTripGroup(const QString &tgId) const;
 
     ReservationManager *m_resMgr = nullptr;
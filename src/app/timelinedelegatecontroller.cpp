@@ -8,6 +8,7 @@
 
 #include "calendarhelper.h"
 #include "constants.h"
+#include "deadlinescheduler.h"
 #include "documentmanager.h"
 #include "livedatamanager.h"
 #include "locationhelper.h"
@@ -49,7 +50,6 @@
 
 using namespace Qt::Literals;
 
-QChronoTimer *TimelineDelegateController::s_currentTimer = nullptr;
 int TimelineDelegateController::s_progressRefCount = 0;
 QTimer *TimelineDelegateController::s_progressTimer = nullptr;
 
@@ -58,15 +58,6 @@ using namespace KItinerary;
 TimelineDelegateController::TimelineDelegateController(QObject *parent)
     : QObject(parent)
 {
-    if (!s_currentTimer) {
-        s_currentTimer = new QChronoTimer(QCoreApplication::instance());
-        s_currentTimer->setSingleShot(true);
-        s_currentTimer->setTimerType(Qt::VeryCoarseTimer);
-    }
-    connect(s_currentTimer, &QChronoTimer::timeout, this, [this]() {
-        checkForUpdate(m_batchId);
-    });
-
     connect(this, &TimelineDelegateController::contentChanged, this, &TimelineDelegateController::connectionWarningChanged);
 }
 
@@ -265,6 +256,22 @@ KPublicTransport::JourneySection TimelineDelegateController::trip() const
     return m_liveDataMgr->trip(m_batchId);
 }
 
+KPublicTransport::JourneySection TimelineDelegateController::tripWithPath() const
+{
+    if (!m_liveDataMgr || m_batchId.isEmpty()) {
+        return {};
+    }
+    return m_liveDataMgr->tripWithPath(m_batchId);
+}
+
+bool TimelineDelegateController::hasPath() const
+{
+    if (!m_liveDataMgr || m_batchId.isEmpty()) {
+        return false;
+    }
+    return m_liveDataMgr->hasPath(m_batchId);
+}
+
 qsizetype TimelineDelegateController::tripDepartureIndex() const
 {
     if (!m_liveDataMgr || m_batchId.isEmpty()) {
@@ -284,6 +291,7 @@ qsizetype TimelineDelegateController::tripArrivalIndex() const
 void TimelineDelegateController::checkForUpdate(const QString &batchId)
 {
     if (!m_resMgr || m_batchId.isEmpty()) {
+        DeadlineScheduler::instance()->cancel(this);
         setCurrent(false);
         return;
     }
@@ -293,9 +301,11 @@ void TimelineDelegateController::checkForUpdate(const QString &batchId)
 
     const auto res = m_resMgr->reservation(batchId);
     if (!LocationUtil::isLocationChange(res)) {
+        DeadlineScheduler::instance()->cancel(this);
         return;
     }
     if (ReservationHelper::isCancelled(res)) {
+        DeadlineScheduler::instance()->cancel(this);
         setCurrent(false);
         return;
     }
@@ -307,9 +317,11 @@ void TimelineDelegateController::checkForUpdate(const QString &batchId)
     setCurrent(startTime < now && now < endTime, res);
 
     if (now < startTime) {
-        scheduleNextUpdate(std::chrono::seconds(now.secsTo(startTime) + 1));
+        scheduleNextUpdate(startTime);
     } else if (now < endTime) {
-        scheduleNextUpdate(std::chrono::seconds(now.secsTo(endTime) + 1));
+        scheduleNextUpdate(endTime);
+    } else {
+        DeadlineScheduler::instance()->cancel(this);
     }
 }
 
@@ -350,13 +362,16 @@ QDateTime TimelineDelegateController::liveEndDateTime(const QVariant &res) const
     return SortUtil::endDateTime(res);
 }
 
-void TimelineDelegateController::scheduleNextUpdate(std::chrono::milliseconds ms)
+void TimelineDelegateController::scheduleNextUpdate(const QDateTime &dt)
 {
-    if (s_currentTimer->isActive() && s_currentTimer->remainingTime() < ms) {
-        return;
-    }
-    s_currentTimer->setInterval(ms);
-    s_currentTimer->start();
+    // a few seconds delay don't matter here, and this allows to update delegates in batches
+    DeadlineScheduler::instance()->schedule(
+        this,
+        dt.addSecs(1),
+        [this]() {
+            checkForUpdate(m_batchId);
+        },
+        std::chrono::seconds(5));
 }
 
 void TimelineDelegateController::batchChanged(const QString &batchId)
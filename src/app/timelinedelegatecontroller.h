@@ -18,12 +18,9 @@
 #include <QVariant>
 #include <qqmlintegration.h>
 
-#include <chrono>
-
 class QDateTime;
 class QJSValue;
 class QTimer;
-class QChronoTimer;
 
 class LiveDataManager;
 class ReservationManager;
@@ -57,6 +54,11 @@ class TimelineDelegateController : public QObject
     Q_PROPERTY(KPublicTransport::JourneySection journey READ journey NOTIFY journeyChanged)
 
     Q_PROPERTY(KPublicTransport::JourneySection trip READ trip NOTIFY journeyChanged)
+    /** Same as trip, but including the path geometry, which is loaded on demand.
+     *  Only use this where the path is actually needed, such as for maps.
+     */
+    Q_PROPERTY(KPublicTransport::JourneySection tripWithPath READ tripWithPath NOTIFY journeyChanged)
+    Q_PROPERTY(bool hasPath READ hasPath NOTIFY journeyChanged)
     Q_PROPERTY(qsizetype tripDepartureIndex READ tripDepartureIndex NOTIFY journeyChanged)
     Q_PROPERTY(qsizetype tripArrivalIndex READ tripArrivalIndex NOTIFY journeyChanged)
 
@@ -125,6 +127,8 @@ public:
     [[nodiscard]] KPublicTransport::JourneySection journey() const;
 
     [[nodiscard]] KPublicTransport::JourneySection trip() const;
+    [[nodiscard]] KPublicTransport::JourneySection tripWithPath() const;
+    [[nodiscard]] bool hasPath() const;
     [[nodiscard]] qsizetype tripDepartureIndex() const;
     [[nodiscard]] qsizetype tripArrivalIndex() const;
 
@@ -193,8 +197,7 @@ private:
     QString m_batchId;
     bool m_isCurrent = false;
 
-    static void scheduleNextUpdate(std::chrono::milliseconds ms);
-    static QChronoTimer *s_currentTimer;
+    void scheduleNextUpdate(const QDateTime &dt);
     static int s_progressRefCount;
     static QTimer *s_progressTimer;
 };
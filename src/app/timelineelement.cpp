@@ -21,6 +21,9 @@
 #include <KPublicTransport/Journey>
 #include <KPublicTransport/Stopover>
 
+#include <algorithm>
+#include <limits>
+
 using namespace KItinerary;
 
 static TimelineElement::ElementType elementType(const QVariant &res)
@@ -55,32 +58,62 @@ static TimelineElement::ElementType elementType(const QVariant &res)
     return {};
 }
 
-TimelineElement::TimelineElement() = default;
+[[nodiscard]] static qint64 sortKey(const QDateTime &dt)
+{
+    // invalid times sort first, same as with QDateTime comparison
+    return dt.isValid() ? dt.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+}
+
+// no end time, sorts before any actual duration
+constexpr inline const qint32 NoDuration = std::numeric_limits<qint32>::min();
+
+[[nodiscard]] static qint32 duration(const QDateTime &begin, const QDateTime &end)
+{
+    if (!end.isValid()) {
+        return NoDuration;
+    }
+    if (!begin.isValid()) {
+        return 0;
+    }
+    return (qint32)std::clamp<qint64>(begin.secsTo(end), NoDuration + 1, std::numeric_limits<qint32>::max());
+}
+
+TimelineElement::TimelineElement()
+    : m_duration(NoDuration)
+    , m_sortKey(sortKey({}))
+{
+}
 
 TimelineElement::TimelineElement(TimelineModel *model, TimelineElement::ElementType type, const QDateTime &dateTime, const QVariant &data)
-    : dt(dateTime)
-    , elementType(type)
+    : elementType(type)
+    , m_duration(NoDuration)
+    , m_dt(dateTime)
+    , m_sortKey(sortKey(m_dt))
     , m_content(data)
     , m_model(model)
 {
 }
 
 TimelineElement::TimelineElement(TimelineModel *model, const QString &resId, const QVariant &res, TimelineElement::RangeType rt)
-    : dt(relevantDateTime(res, rt))
-    , elementType(::elementType(res))
+    : elementType(::elementType(res))
     , rangeType(rt)
+    , m_dt(relevantDateTime(res, rt))
+    , m_sortKey(sortKey(m_dt))
     , m_content(resId)
     , m_model(model)
 {
+    m_duration = duration(m_dt, SortUtil::endDateTime(res));
 }
 
 TimelineElement::TimelineElement(TimelineModel *model, const ::Transfer &transfer)
-    : dt(transfer.alignment() == Transfer::Before ? transfer.anchorTime().addSecs(-transfer.anchorTimeDelta()) : transfer.anchorTime())
-    , elementType(Transfer)
+    : elementType(Transfer)
     , rangeType(SelfContained)
+    , m_dt(transfer.alignment() == Transfer::Before ? transfer.anchorTime().addSecs(-transfer.anchorTimeDelta()) : transfer.anchorTime())
+    , m_sortKey(sortKey(m_dt))
     , m_content(QVariant::fromValue(transfer))
     , m_model(model)
 {
+    m_duration = duration(m_dt, transfer.state() == Transfer::Selected ? transfer.journey().scheduledArrivalTime() : QDateTime());
 }
 
 static bool operator<(TimelineElement::RangeType lhs, TimelineElement::RangeType rhs)
@@ -91,9 +124,10 @@ static bool operator<(TimelineElement::RangeType lhs, TimelineElement::RangeType
 
 bool TimelineElement::operator<(const TimelineElement &other) const
 {
-    if (dt == other.dt) {
+    if (m_sortKey == other.m_sortKey) {
         if (rangeType == other.rangeType && elementType == other.elementType) {
-            return endDateTime().isValid() && endDateTime() > other.endDateTime();
+            // longer first, with the same start time that's the same as comparing end times
+            return m_duration > other.m_duration;
         }
         if (rangeType == RangeEnd || other.rangeType == RangeEnd) {
             if (rangeType == RangeBegin || other.rangeType == RangeBegin) {
@@ -103,12 +137,12 @@ bool TimelineElement::operator<(const TimelineElement &other) const
         }
         return elementType < other.elementType;
     }
-    return dt < other.dt;
+    return m_sortKey < other.m_sortKey;
 }
 
 bool TimelineElement::operator<(const QDateTime &otherDt) const
 {
-    return dt < otherDt;
+    return m_sortKey < sortKey(otherDt);
 }
 
 bool TimelineElement::operator==(const TimelineElement &other) const
@@ -124,7 +158,7 @@ bool TimelineElement::operator==(const TimelineElement &other) const
         return lhsT.alignment() == rhsT.alignment();
     }
     default:
-        return dt == other.dt;
+        return m_sortKey == other.m_sortKey;
     }
 }
 
@@ -222,7 +256,7 @@ bool TimelineElement::isTimeBoxed() const
     case Restaurant:
     case TouristAttraction:
     case Event:
-        return SortUtil::endDateTime(m_model->m_resMgr->reservation(batchId())).isValid();
+        return m_duration != NoDuration;
     }
     return false;
 }
@@ -322,18 +356,31 @@ QVariant TimelineElement::destination() const
     return {};
 }
 
+QDateTime TimelineElement::dateTime() const
+{
+    return m_dt;
+}
+
+void TimelineElement::setDateTime(const QDateTime &dateTime)
+{
+    m_dt = dateTime;
+    m_sortKey = sortKey(m_dt);
+}
+
 QDateTime TimelineElement::endDateTime() const
 {
+    // only the end time's position is cached, the time zone needs the full data
+    if (m_duration == NoDuration) {
+        return {};
+    }
+
     if (isReservation()) {
         const auto res = m_model->m_resMgr->reservation(batchId());
         return SortUtil::endDateTime(res);
     }
 
     if (elementType == Transfer) {
-        const auto transfer = m_content.value<::Transfer>();
-        if (transfer.state() == Transfer::Selected) {
-            return transfer.journey().scheduledArrivalTime();
-        }
+        return m_content.value<::Transfer>().journey().scheduledArrivalTime();
     }
 
     return {};
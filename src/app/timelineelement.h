@@ -29,7 +29,7 @@ class TimelineElement
 
 public:
     // Note: the order in here defines the priority of element if they occur at the same time
-    enum ElementType {
+    enum ElementType : quint8 {
         Undefined,
         TodayMarker,
         WeatherForecast,
@@ -48,7 +48,7 @@ public:
     Q_ENUM(ElementType)
 
     // indicates whether an element is self-contained or the beginning/end of a longer timespan/range
-    enum RangeType { SelfContained, RangeBegin, RangeEnd };
+    enum RangeType : quint8 { SelfContained, RangeBegin, RangeEnd };
     Q_ENUM(RangeType)
 
     explicit TimelineElement();
@@ -56,7 +56,9 @@ public:
     explicit TimelineElement(TimelineModel *model, const QString &resId, const QVariant &res, RangeType rt);
     explicit TimelineElement(TimelineModel *model, const ::Transfer &transfer);
 
-    /** Timeline order. This considers only position in the timeline, not content. */
+    /** Timeline order. This considers only position in the timeline, not content.
+     *  This only uses data cached on construction, so it doesn't need to look up any reservations.
+     */
     bool operator<(const TimelineElement &other) const;
     bool operator<(const QDateTime &otherDt) const;
     bool operator==(const TimelineElement &other) const;
@@ -98,6 +100,11 @@ public:
      */
     QVariant destination() const;
 
+    /** Relevant date/time, ie. the position of this element in the timeline. */
+    [[nodiscard]] QDateTime dateTime() const;
+    /** Move this element to @p dateTime. */
+    void setDateTime(const QDateTime &dateTime);
+
     /** End or arrival time.
      *  For location changes this is the arrival time.
      *  For timeboxed elements this is the end time.
@@ -107,11 +114,15 @@ public:
     /** The time @p res is added to the timeline, for range type @p range. */
     static QDateTime relevantDateTime(const QVariant &res, TimelineElement::RangeType range);
 
-    QDateTime dt; // relevant date/time
     ElementType elementType = Undefined;
     RangeType rangeType = SelfContained;
 
 private:
+    // end time as seconds after m_dt, packed next to the element and range types
+    qint32 m_duration;
+    QDateTime m_dt;
+    // m_dt in msecs since epoch, for comparison without time zone conversions
+    qint64 m_sortKey;
     QVariant m_content;
     TimelineModel *m_model = nullptr;
 };
@@ -7,7 +7,10 @@
 #include "timelinemodel.h"
 #include "locationhelper.h"
 #include "locationinformation.h"
+#include "logging.h"
+#include "reservationhelper.h"
 #include "reservationmanager.h"
+#include "timezonecache.h"
 #include "transfermanager.h"
 #include "tripgroupmanager.h"
 #include "weatherinformation.h"
@@ -36,9 +39,17 @@
 #include <QLocale>
 
 #include <cassert>
+#include <utility>
 
 using namespace KItinerary;
 
+// initial time window in windowed mode, and the minimum amount by which it is extended
+constexpr const auto WINDOW_DAYS_BEFORE = 14;
+constexpr const auto WINDOW_DAYS_AFTER = 28;
+constexpr const auto WINDOW_EXTENSION_DAYS = 28;
+// upper bound for how long a time-boxed element can be ongoing, limits the search for elements ending in the future
+constexpr const auto MAX_ONGOING_SECS = 48 * 3600;
+
 static bool needsSplitting(const QVariant &res)
 {
     // multi-day event?
@@ -62,6 +73,24 @@ static QTimeZone timeZone(const QDateTime &dt)
     return dt.timeSpec() == Qt::TimeZone ? dt.timeZone() : QTimeZone();
 }
 
+/** Extend the time range [@p begin, @p end] affected by a change to include @p dt. */
+static void extendRange(QDateTime &begin, QDateTime &end, const QDateTime &dt)
+{
+    if (!dt.isValid()) {
+        return;
+    }
+    begin = begin.isValid() ? std::min(begin, dt) : dt;
+    end = end.isValid() ? std::max(end, dt) : dt;
+}
+
+/** Location changes with a known destination timezone fully determine the location
+ *  information state after them, independent of anything before.
+ */
+static bool isInformationAnchor(const TimelineElement &elem)
+{
+    return !elem.isInformational() && !elem.isCanceled() && elem.isLocationChange() && timeZone(elem.endDateTime()).isValid();
+}
+
 TimelineModel::TimelineModel(QObject *parent)
     : QAbstractListModel(parent)
 {
@@ -71,6 +100,10 @@ TimelineModel::TimelineModel(QObject *parent)
     m_dayUpdateTimer.setInterval((QTime::currentTime().secsTo({23, 59, 59}) + 1) * 1000);
     m_dayUpdateTimer.start();
 
+    connect(&m_transitionTimer, &QChronoTimer::timeout, this, &TimelineModel::transitionReached);
+    m_transitionTimer.setTimerType(Qt::VeryCoarseTimer);
+    m_transitionTimer.setSingleShot(true);
+
     // make sure we properly update the empty today marker
     connect(this, &TimelineModel::todayRowChanged, this, [this]() {
         const auto row = todayRow();
@@ -85,7 +118,20 @@ TimelineModel::TimelineModel(QObject *parent)
         Q_EMIT dataChanged(idx, idx);
     });
 
+    // any change to the content is accompanied by this, so that's the point to look for the next transition
+    connect(this, &TimelineModel::todayRowChanged, this, &TimelineModel::scheduleTransitionUpdate);
+
     connect(this, &TimelineModel::initialLocationChanged, this, &TimelineModel::updateWeatherElements);
+
+    // the row index stores positions in time rather than rows, so only the inserted or removed elements need updating
+    connect(this, &TimelineModel::rowsInserted, this, [this](const QModelIndex &, int first, int last) {
+        rowIndexRowsInserted(first, last);
+    });
+    connect(this, &TimelineModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &, int first, int last) {
+        rowIndexRowsAboutToBeRemoved(first, last);
+    });
+    connect(this, &TimelineModel::rowsMoved, this, &TimelineModel::invalidateRowIndex);
+    connect(this, &TimelineModel::modelReset, this, &TimelineModel::invalidateRowIndex);
 }
 
 TimelineModel::~TimelineModel() = default;
@@ -102,6 +148,12 @@ void TimelineModel::setReservationManager(ReservationManager *mgr)
     connect(mgr, &ReservationManager::batchChanged, this, &TimelineModel::batchChanged);
     connect(mgr, &ReservationManager::batchContentChanged, this, &TimelineModel::batchChanged);
     connect(mgr, &ReservationManager::batchRemoved, this, &TimelineModel::batchRemoved);
+    connect(mgr, &ReservationManager::batchesLoaded, this, [this](const QStringList &batchIds) {
+        if (!m_isPrefetched && batchIds == m_prefetchBatchIds) {
+            m_isPrefetched = true;
+            populate();
+        }
+    });
     Q_EMIT setupChanged();
     QMetaObject::invokeMethod(this, &TimelineModel::populate, Qt::QueuedConnection);
 }
@@ -114,7 +166,7 @@ void TimelineModel::setWeatherForecastManager(WeatherForecastManager *mgr)
 
     m_weatherMgr = mgr;
     updateWeatherElements();
-    connect(m_weatherMgr, &WeatherForecastManager::forecastUpdated, this, &TimelineModel::updateWeatherElements);
+    connect(m_weatherMgr, &WeatherForecastManager::forecastTilesUpdated, this, &TimelineModel::weatherTilesUpdated);
     Q_EMIT setupChanged();
 }
 
@@ -170,11 +222,18 @@ void TimelineModel::setTripGroupId(const QString &tgId)
 
     m_tripGroupId = tgId;
     m_tripGroup = m_tripGroupManager->tripGroup(tgId);
+    m_prefetchBatchIds.clear();
+    m_isPrefetched = false;
+    m_windowBegin = {};
+    m_windowEnd = {};
     Q_EMIT tripGroupIdChanged();
 
     if (m_isPopulated) {
         beginResetModel();
         m_elements.clear();
+        m_todayMarkerDt = {};
+        m_weatherSlots.clear();
+        m_sortedReservations.clear();
         m_isPopulated = false;
         endResetModel();
     }
@@ -199,18 +258,18 @@ QVariant TimelineModel::data(const QModelIndex &index, int role) const
     switch (role) {
     case SectionHeaderRole:
         // see TimelineSectionDelegateController
-        return elem.dt.date().toString(Qt::ISODate);
+        return elem.dateTime().date().toString(Qt::ISODate);
     case BatchIdRole:
         return elem.isReservation() ? elem.batchId() : QString();
     case ElementTypeRole:
         return elem.elementType;
     case TodayEmptyRole:
         if (elem.elementType == TimelineElement::TodayMarker) {
-            return isDateEmpty(m_elements.at(index.row()).dt.date());
+            return isDateEmpty(m_elements.at(index.row()).dateTime().date());
         }
         return {};
     case IsTodayRole:
-        return elem.dt.date() == today();
+        return elem.dateTime().date() == today();
     case ElementRangeRole:
         return elem.rangeType;
     case LocationInformationRole:
@@ -227,14 +286,7 @@ QVariant TimelineModel::data(const QModelIndex &index, int role) const
         if (!elem.isReservation()) {
             return {};
         }
-        const auto resIds = m_resMgr->reservationsForBatch(elem.batchId());
-        QList<QVariant> v;
-        v.reserve(resIds.size());
-        for (const auto &resId : resIds) {
-            v.push_back(m_resMgr->reservation(resId));
-        }
-        std::sort(v.begin(), v.end(), SortUtil::isBefore);
-        return QVariant::fromValue(v);
+        return QVariant::fromValue(sortedReservations(elem.batchId()));
     }
     case TransferRole:
         if (elem.elementType == TimelineElement::Transfer) {
@@ -242,13 +294,15 @@ QVariant TimelineModel::data(const QModelIndex &index, int role) const
         }
         break;
     case StartDateTimeRole:
-        return elem.dt;
+        return elem.dateTime();
     case EndDateTimeRole:
         return elem.endDateTime();
     case IsTimeboxedRole:
         return elem.isTimeBoxed();
     case IsCanceledRole:
         return elem.isCanceled();
+    case IsCurrentRole:
+        return elem.isTimeBoxed() && elem.dateTime() <= now() && now() < elem.endDateTime();
     }
     return {};
 }
@@ -266,15 +320,27 @@ QHash<int, QByteArray> TimelineModel::roleNames() const
     names.insert(WeatherForecastRole, "weatherInformation");
     names.insert(ReservationsRole, "reservations");
     names.insert(TransferRole, "transfer");
+    names.insert(IsCurrentRole, "isCurrent");
     return names;
 }
 
 int TimelineModel::todayRow() const
 {
-    const auto it = std::find_if(m_elements.begin(), m_elements.end(), [](const auto &e) {
-        return e.elementType == TimelineElement::TodayMarker;
-    });
-    return it != m_elements.end() ? (int)std::distance(m_elements.begin(), it) : -1;
+    if (!m_todayMarkerDt.isValid()) {
+        return -1;
+    }
+    // elements at the same time might precede the marker
+    for (auto it = std::lower_bound(m_elements.begin(), m_elements.end(), m_todayMarkerDt); it != m_elements.end() && (*it).dateTime() == m_todayMarkerDt; ++it) {
+        if ((*it).elementType == TimelineElement::TodayMarker) {
+            return (int)std::distance(m_elements.begin(), it);
+        }
+    }
+    return -1;
+}
+
+int TimelineModel::firstRowAtOrAfter(const QDateTime &dt) const
+{
+    return (int)std::distance(m_elements.begin(), std::lower_bound(m_elements.begin(), m_elements.end(), dt));
 }
 
 void TimelineModel::populate()
@@ -282,11 +348,31 @@ void TimelineModel::populate()
     if (m_isPopulated || !m_resMgr || !m_transferManager || !m_tripGroupManager || m_tripGroupId.isEmpty()) {
         return;
     }
+
+    // load all reservations in parallel first, rather than one by one below
+    if (!m_isPrefetched) {
+        const auto tg = m_tripGroupManager->tripGroup(m_tripGroupId);
+        if (m_windowed && !m_windowBegin.isValid()) {
+            resetWindow(tg);
+        }
+        const auto elems = batchesInWindow(tg.elements());
+        if (!elems.isEmpty()) {
+            if (elems != m_prefetchBatchIds) {
+                m_prefetchBatchIds = elems;
+                m_resMgr->loadBatchesAsync(m_prefetchBatchIds);
+            }
+            return;
+        }
+        m_isPrefetched = true; // nothing to load
+    }
     m_isPopulated = true;
 
     beginResetModel();
     m_tripGroup = m_tripGroupManager->tripGroup(m_tripGroupId);
-    const auto elems = m_tripGroup.elements();
+    if (m_windowed && !m_windowBegin.isValid()) {
+        resetWindow(m_tripGroup);
+    }
+    const auto elems = batchesInWindow(m_tripGroup.elements());
     for (const auto &resId : elems) {
         populateReservation(resId);
     }
@@ -298,9 +384,189 @@ void TimelineModel::populate()
         updateTransfersForBatch(batchId);
     }
 
+    updateWindowContext();
     updateTodayMarker();
     updateInformationElements();
     Q_EMIT todayRowChanged();
+    Q_EMIT windowChanged();
+}
+
+void TimelineModel::setWindowed(bool windowed)
+{
+    if (m_windowed == windowed) {
+        return;
+    }
+
+    m_windowed = windowed;
+    m_windowBegin = {};
+    m_windowEnd = {};
+    Q_EMIT setupChanged();
+
+    if (m_isPopulated) {
+        beginResetModel();
+        m_elements.clear();
+        m_todayMarkerDt = {};
+        m_weatherSlots.clear();
+        m_sortedReservations.clear();
+        m_isPopulated = false;
+        m_isPrefetched = false;
+        m_prefetchBatchIds.clear();
+        endResetModel();
+        QMetaObject::invokeMethod(this, &TimelineModel::populate, Qt::QueuedConnection);
+    }
+}
+
+void TimelineModel::resetWindow(const TripGroup &tg)
+{
+    auto anchor = now();
+    if (tg.beginDateTime().isValid()) {
+        anchor = std::max(anchor, tg.beginDateTime());
+    }
+    if (tg.endDateTime().isValid()) {
+        anchor = std::min(anchor, tg.endDateTime());
+    }
+    m_windowBegin = anchor.addDays(-WINDOW_DAYS_BEFORE);
+    m_windowEnd = anchor.addDays(WINDOW_DAYS_AFTER);
+}
+
+bool TimelineModel::isInWindow(const QString &batchId) const
+{
+    if (!m_windowed || !m_windowBegin.isValid()) {
+        return true;
+    }
+
+    const auto batch = m_resMgr->batch(batchId);
+    if (!batch.startDateTime().isValid()) {
+        return true;
+    }
+    const auto endDt = batch.endDateTime().isValid() ? batch.endDateTime() : batch.startDateTime();
+    return endDt >= m_windowBegin && batch.startDateTime() <= m_windowEnd;
+}
+
+QStringList TimelineModel::batchesInWindow(const QStringList &batchIds) const
+{
+    if (!m_windowed) {
+        return batchIds;
+    }
+
+    QStringList result;
+    std::copy_if(batchIds.begin(), batchIds.end(), std::back_inserter(result), [this](const auto &batchId) {
+        return isInWindow(batchId);
+    });
+    return result;
+}
+
+bool TimelineModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !m_windowed || !m_isPopulated) {
+        return false;
+    }
+    // elements are sorted by start time
+    const auto elems = m_tripGroup.elements();
+    return !elems.isEmpty() && m_resMgr->batch(elems.back()).startDateTime() > m_windowEnd;
+}
+
+void TimelineModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    // extend at least up to the next batch, so this always adds something
+    auto windowEnd = m_windowEnd.addDays(WINDOW_EXTENSION_DAYS);
+    const auto elems = m_tripGroup.elements();
+    for (const auto &batchId : elems) {
+        if (const auto startDt = m_resMgr->batch(batchId).startDateTime(); startDt > m_windowEnd) {
+            windowEnd = std::max(windowEnd, startDt);
+            break;
+        }
+    }
+    extendWindow(m_windowBegin, windowEnd);
+}
+
+bool TimelineModel::canFetchEarlier() const
+{
+    if (!m_windowed || !m_isPopulated) {
+        return false;
+    }
+    const auto elems = m_tripGroup.elements();
+    return std::any_of(elems.begin(), elems.end(), [this](const auto &batchId) {
+        const auto startDt = m_resMgr->batch(batchId).startDateTime();
+        return startDt.isValid() && startDt < m_windowBegin && !isInWindow(batchId);
+    });
+}
+
+void TimelineModel::fetchEarlier()
+{
+    if (!canFetchEarlier()) {
+        return;
+    }
+
+    // extend at least back to the previous batch, so this always adds something
+    auto windowBegin = m_windowBegin.addDays(-WINDOW_EXTENSION_DAYS);
+    const auto elems = m_tripGroup.elements();
+    for (auto it = elems.rbegin(); it != elems.rend(); ++it) {
+        if (const auto startDt = m_resMgr->batch(*it).startDateTime(); startDt.isValid() && startDt < m_windowBegin && !isInWindow(*it)) {
+            windowBegin = std::min(windowBegin, startDt);
+            break;
+        }
+    }
+    extendWindow(windowBegin, m_windowEnd);
+}
+
+void TimelineModel::extendWindow(const QDateTime &begin, const QDateTime &end)
+{
+    const auto elems = m_tripGroup.elements();
+    QStringList added;
+    for (const auto &batchId : elems) {
+        if (!isInWindow(batchId)) {
+            added.push_back(batchId);
+        }
+    }
+
+    m_windowBegin = begin;
+    m_windowEnd = end;
+    added = batchesInWindow(added);
+    qCDebug(Log) << "extending timeline window to" << m_windowBegin << m_windowEnd << "adding" << added.size() << "batches";
+
+    QDateTime changeBegin, changeEnd;
+    for (const auto &batchId : added) {
+        insertReservation(batchId, changeBegin, changeEnd);
+    }
+    updateWindowContext();
+    updateInformationElements(changeBegin, changeEnd);
+    for (const auto &batchId : added) {
+        updateTransfersForBatch(batchId);
+    }
+    updateTodayMarker();
+
+    Q_EMIT todayRowChanged();
+    Q_EMIT windowChanged();
+}
+
+void TimelineModel::updateWindowContext()
+{
+    m_windowContextLocation = {};
+    m_windowContextTime = {};
+    if (!m_windowed) {
+        return;
+    }
+
+    // the location we are in at the start of the window, for location and weather information
+    const auto elems = m_tripGroup.elements();
+    for (auto it = elems.rbegin(); it != elems.rend(); ++it) {
+        const auto batch = m_resMgr->batch(*it);
+        if (!batch.startDateTime().isValid() || batch.startDateTime() >= m_windowBegin || isInWindow(*it)) {
+            continue;
+        }
+        const auto res = m_resMgr->reservation(*it);
+        if (!LocationUtil::isLocationChange(res) || ReservationHelper::isCancelled(res)) {
+            continue;
+        }
+        m_windowContextLocation = LocationUtil::arrivalLocation(res);
+        m_windowContextTime = SortUtil::endDateTime(res);
+        return;
+    }
 }
 
 void TimelineModel::populateReservation(const QString &resId)
@@ -320,21 +586,30 @@ void TimelineModel::populateReservation(const QString &resId)
 
 void TimelineModel::batchAdded(const QString &resId)
 {
-    if (!m_isPopulated || !m_tripGroup.elements().contains(resId)) {
+    if (!m_isPopulated || !m_tripGroup.elements().contains(resId) || !isInWindow(resId)) {
         return;
     }
 
+    QDateTime changeBegin, changeEnd;
+    insertReservation(resId, changeBegin, changeEnd);
+    updateInformationElements(changeBegin, changeEnd);
+    updateTransfersForBatch(resId);
+    Q_EMIT todayRowChanged();
+}
+
+void TimelineModel::insertReservation(const QString &resId, QDateTime &changeBegin, QDateTime &changeEnd)
+{
     const auto res = m_resMgr->reservation(resId);
     if (needsSplitting(res)) {
         insertElement(TimelineElement{this, resId, res, TimelineElement::RangeBegin});
         insertElement(TimelineElement{this, resId, res, TimelineElement::RangeEnd});
+        extendRange(changeBegin, changeEnd, TimelineElement::relevantDateTime(res, TimelineElement::RangeBegin));
+        extendRange(changeBegin, changeEnd, TimelineElement::relevantDateTime(res, TimelineElement::RangeEnd));
     } else {
         insertElement(TimelineElement{this, resId, res, TimelineElement::SelfContained});
+        extendRange(changeBegin, changeEnd, TimelineElement::relevantDateTime(res, TimelineElement::SelfContained));
     }
-
-    updateInformationElements();
-    updateTransfersForBatch(resId);
-    Q_EMIT todayRowChanged();
+    extendRange(changeBegin, changeEnd, SortUtil::endDateTime(res));
 }
 
 int TimelineModel::insertElement(TimelineElement &&elem)
@@ -363,6 +638,10 @@ std::vector<TimelineElement>::iterator TimelineModel::insertOrUpdate(std::vector
     if (it != m_elements.end() && (*it) == elem) {
         const auto row = (int)std::distance(m_elements.begin(), it);
         (*it) = std::move(elem);
+        // transfers are equal independent of their time, so their position in the row index might have changed
+        if (auto slot = m_rowIndexValid ? rowIndexSlot(*it) : nullptr) {
+            *slot = (*it).dateTime();
+        }
         Q_EMIT dataChanged(index(row, 0), index(row, 0));
     } else {
         const auto row = (int)std::distance(m_elements.begin(), it);
@@ -375,68 +654,84 @@ std::vector<TimelineElement>::iterator TimelineModel::insertOrUpdate(std::vector
 
 void TimelineModel::batchChanged(const QString &resId)
 {
+    m_sortedReservations.remove(resId);
     if (!m_isPopulated || !m_tripGroup.elements().contains(resId)) {
         return;
     }
+    // not created yet as it was outside of the time window so far
+    if (m_windowed && firstRowForReservation(resId) < 0) {
+        batchAdded(resId);
+        return;
+    }
+
+    // the previous positions are affected as well in case elements move
+    QDateTime changeBegin, changeEnd;
+    for (const auto rangeType : {TimelineElement::SelfContained, TimelineElement::RangeBegin, TimelineElement::RangeEnd}) {
+        if (const auto row = rowForReservation(resId, rangeType); row >= 0) {
+            extendRange(changeBegin, changeEnd, m_elements[row].dateTime());
+        }
+    }
 
     const auto res = m_resMgr->reservation(resId);
     if (needsSplitting(res)) {
         updateElement(resId, res, TimelineElement::RangeBegin);
         updateElement(resId, res, TimelineElement::RangeEnd);
+        extendRange(changeBegin, changeEnd, TimelineElement::relevantDateTime(res, TimelineElement::RangeBegin));
+        extendRange(changeBegin, changeEnd, TimelineElement::relevantDateTime(res, TimelineElement::RangeEnd));
     } else {
         updateElement(resId, res, TimelineElement::SelfContained);
+        extendRange(changeBegin, changeEnd, TimelineElement::relevantDateTime(res, TimelineElement::SelfContained));
     }
+    extendRange(changeBegin, changeEnd, SortUtil::endDateTime(res));
 
-    updateInformationElements();
+    updateInformationElements(changeBegin, changeEnd);
 }
 
 void TimelineModel::updateElement(const QString &resId, const QVariant &res, TimelineElement::RangeType rangeType)
 {
-    const auto it = std::find_if(m_elements.begin(), m_elements.end(), [resId, rangeType](const auto &e) {
-        return e.isReservation() && e.batchId() == resId && e.rangeType == rangeType;
-    });
-    if (it == m_elements.end()) {
+    const auto row = rowForReservation(resId, rangeType);
+    if (row < 0) {
         return;
     }
-    const auto row = (int)std::distance(m_elements.begin(), it);
+    const auto it = m_elements.begin() + row;
     const auto newDt = TimelineElement::relevantDateTime(res, rangeType);
 
-    if ((*it).dt != newDt) {
+    if ((*it).dateTime() != newDt) {
         // element moved
         beginRemoveRows({}, row, row);
         m_elements.erase(it);
         endRemoveRows();
         insertElement(TimelineElement{this, resId, res, rangeType});
     } else {
+        // refresh data cached in the element, such as the end time
+        (*it) = TimelineElement{this, resId, res, rangeType};
         Q_EMIT dataChanged(index(row, 0), index(row, 0));
     }
 }
 
 void TimelineModel::batchRemoved(const QString &resId)
 {
+    m_sortedReservations.remove(resId);
     if (!m_isPopulated) {
         return;
     }
 
-    const auto it = std::find_if(m_elements.begin(), m_elements.end(), [resId](const auto &e) {
-        return e.isReservation() && e.batchId() == resId;
-    });
-    if (it == m_elements.end()) {
+    // split elements have two rows
+    QDateTime changeBegin, changeEnd;
+    bool removed = false;
+    for (auto row = firstRowForReservation(resId); row >= 0; row = firstRowForReservation(resId)) {
+        extendRange(changeBegin, changeEnd, m_elements[row].dateTime());
+        beginRemoveRows({}, row, row);
+        m_elements.erase(m_elements.begin() + row);
+        endRemoveRows();
+        removed = true;
+    }
+    if (!removed) {
         return;
     }
-    const auto isSplit = (*it).rangeType == TimelineElement::RangeBegin;
-    const auto row = (int)std::distance(m_elements.begin(), it);
-
-    beginRemoveRows({}, row, row);
-    m_elements.erase(it);
-    endRemoveRows();
     Q_EMIT todayRowChanged();
 
-    if (isSplit) {
-        batchRemoved(resId);
-    }
-
-    updateInformationElements();
+    updateInformationElements(changeBegin, changeEnd);
 }
 
 void TimelineModel::dayChanged()
@@ -460,13 +755,14 @@ void TimelineModel::updateTodayMarker()
             const auto prevIt = std::prev(it);
             // check if the previous element is the old today marker, if so nothing to do
             if ((*prevIt).elementType == TimelineElement::TodayMarker) {
-                (*prevIt).dt = dt;
+                (*prevIt).setDateTime(dt);
+                m_todayMarkerDt = dt;
                 return;
             }
             // check if the previous element is still ongoing, in that case we want to be before that
-            if ((*prevIt).dt.date() == today() && ((*prevIt).isTimeBoxed() && (*prevIt).endDateTime() > now())) {
+            if ((*prevIt).dateTime().date() == today() && ((*prevIt).isTimeBoxed() && (*prevIt).endDateTime() > now())) {
                 it = prevIt;
-                dt = (*prevIt).dt;
+                dt = (*prevIt).dateTime();
             }
         }
         newRow = (int)std::distance(m_elements.begin(), it);
@@ -488,10 +784,82 @@ void TimelineModel::updateTodayMarker()
         m_elements.erase(m_elements.begin() + oldRow);
         endRemoveRows();
     }
+    m_todayMarkerDt = newRow >= 0 ? dt : QDateTime();
     Q_EMIT todayRowChanged();
 }
 
+void TimelineModel::scheduleTransitionUpdate()
+{
+    m_transitionTimer.stop();
+    if (!m_isPopulated) {
+        return;
+    }
+
+    const auto currentDt = now();
+    if (!m_lastTransitionCheck.isValid() || m_lastTransitionCheck > currentDt) {
+        m_lastTransitionCheck = currentDt;
+    }
+
+    QDateTime next;
+    const auto consider = [&next, &currentDt](const QDateTime &dt) {
+        if (dt.isValid() && dt > currentDt && (!next.isValid() || dt < next)) {
+            next = dt;
+        }
+    };
+
+    // the next element to start, elements are sorted by start time
+    auto nowIt = std::lower_bound(m_elements.begin(), m_elements.end(), currentDt);
+    for (auto it = nowIt; it != m_elements.end(); ++it) {
+        if (!(*it).isInformational() && (*it).dateTime() > currentDt) {
+            consider((*it).dateTime());
+            break;
+        }
+    }
+    // the next ongoing element to end
+    const auto ongoingBegin = currentDt.addSecs(-MAX_ONGOING_SECS);
+    for (auto it = std::lower_bound(m_elements.begin(), nowIt, ongoingBegin); it != m_elements.end() && (*it).dateTime() <= currentDt; ++it) {
+        if ((*it).isTimeBoxed()) {
+            consider((*it).endDateTime());
+        }
+    }
+
+    if (next.isValid()) {
+        m_transitionTimer.setInterval(std::chrono::milliseconds(currentDt.msecsTo(next)) + std::chrono::seconds(1));
+        m_transitionTimer.start();
+    }
+}
+
+void TimelineModel::transitionReached()
+{
+    const auto currentDt = now();
+    const auto lastCheck = std::exchange(m_lastTransitionCheck, currentDt);
+    const auto passed = [&lastCheck, &currentDt](const QDateTime &dt) {
+        return dt.isValid() && lastCheck < dt && dt <= currentDt;
+    };
+
+    // only touch the rows that departed, arrived or became current since the last check
+    const auto endIt = std::lower_bound(m_elements.begin(), m_elements.end(), currentDt.addSecs(1));
+    for (auto it = std::lower_bound(m_elements.begin(), endIt, lastCheck.addSecs(-MAX_ONGOING_SECS)); it != endIt; ++it) {
+        if ((*it).isInformational()) {
+            continue;
+        }
+        if (passed((*it).dateTime()) || ((*it).isTimeBoxed() && passed((*it).endDateTime()))) {
+            const auto idx = index((int)std::distance(m_elements.begin(), it), 0);
+            Q_EMIT dataChanged(idx, idx, {IsCurrentRole});
+        }
+    }
+
+    // today marker position depends on ongoing elements, this also schedules the next transition
+    updateTodayMarker();
+    scheduleTransitionUpdate();
+}
+
 void TimelineModel::updateInformationElements()
+{
+    updateInformationElements({}, {});
+}
+
+void TimelineModel::updateInformationElements(const QDateTime &changeBegin, const QDateTime &changeEnd)
 {
     // the location information is shown after location changes or before stationary elements
     // when transitioning into a location that:
@@ -504,7 +872,41 @@ void TimelineModel::updateInformationElements()
     homeCountry.setIsoCode(m_homeCountry);
 
     auto previousCountry = homeCountry;
-    for (auto it = m_elements.begin(); it != m_elements.end();) {
+    // in windowed mode, start from where we are at the beginning of the window
+    if (m_windowContextLocation.isValid()) {
+        previousCountry.setIsoCode(LocationUtil::address(m_windowContextLocation).addressCountry());
+        previousCountry.setTimeZone(timeZone(m_windowContextTime), m_windowContextTime);
+    }
+    auto it = m_elements.begin();
+    auto windowBegin = m_elements.begin();
+
+    // for changes in a limited time range we only need to recompute from the last anchor before the change
+    // to the first anchor after the change, beyond that the result is independent of the change
+    if (changeBegin.isValid() && changeEnd.isValid()) {
+        auto anchorIt = std::lower_bound(m_elements.begin(), m_elements.end(), changeBegin);
+        while (anchorIt != m_elements.begin() && !isInformationAnchor(*std::prev(anchorIt))) {
+            --anchorIt;
+        }
+        if (anchorIt != m_elements.begin()) {
+            windowBegin = std::prev(anchorIt);
+            it = anchorIt;
+            previousCountry.setIsoCode(LocationUtil::address((*windowBegin).destination()).addressCountry());
+            previousCountry.setTimeZone(timeZone((*windowBegin).endDateTime()), (*windowBegin).dateTime());
+
+            // continue after the information element of the anchor, if it has one
+            const auto anchorInfoDt = (*windowBegin).endDateTime();
+            for (auto infoIt = it; infoIt != m_elements.end() && (*infoIt).dateTime() <= anchorInfoDt; ++infoIt) {
+                if ((*infoIt).elementType == TimelineElement::LocationInfo && (*infoIt).dateTime() == anchorInfoDt) {
+                    it = std::next(infoIt);
+                    break;
+                }
+            }
+        }
+    }
+    const auto windowBeginRow = std::distance(m_elements.begin(), windowBegin);
+    QDateTime windowEnd;
+
+    while (it != m_elements.end()) {
         if ((*it).elementType == TimelineElement::LocationInfo) { // this is one we didn't generate, otherwise it would be beyond that
             const auto row = (int)std::distance(m_elements.begin(), it);
             beginRemoveRows({}, row, row);
@@ -518,24 +920,33 @@ void TimelineModel::updateInformationElements()
             continue;
         }
 
+        // first anchor after the change, nothing beyond this is affected
+        const auto isWindowEnd = changeEnd.isValid() && (*it).dateTime() > changeEnd && isInformationAnchor(*it);
+        if (isWindowEnd) {
+            windowEnd = (*it).dateTime();
+        }
+
         auto newCountry = homeCountry;
         newCountry.setIsoCode(LocationUtil::address((*it).destination()).addressCountry());
         if (!previousCountry.timeZone().isValid() && (*it).isLocationChange()) {
             // if we don't know the previous timezone, start with the departure location of a location change
-            previousCountry.setTimeZone(timeZone((*it).dt), (*it).dt);
+            previousCountry.setTimeZone(timeZone((*it).dateTime()), (*it).dateTime());
         }
-        newCountry.setTimeZone(previousCountry.timeZone(), (*it).dt);
-        newCountry.setTimeZone(timeZone((*it).endDateTime()), (*it).dt);
+        newCountry.setTimeZone(previousCountry.timeZone(), (*it).dateTime());
+        newCountry.setTimeZone(timeZone((*it).endDateTime()), (*it).dateTime());
         if (newCountry == previousCountry && (!newCountry.leavingEURoaming() || previousCountry.leavingEURoaming())) {
             if (newCountry.timeZone().isValid()) {
                 previousCountry = newCountry;
             }
             ++it;
+            if (isWindowEnd) {
+                break;
+            }
             continue;
         }
         if (!(newCountry == homeCountry) || newCountry.hasRelevantTimeZoneChange(previousCountry) || newCountry.leavingEURoaming()) {
             // for location changes, we want this after the corresponding element
-            auto dt = (*it).isLocationChange() ? (*it).endDateTime() : (*it).dt;
+            auto dt = (*it).isLocationChange() ? (*it).endDateTime() : (*it).dateTime();
             if ((*it).isReservation()) {
                 const auto res = m_resMgr->reservation((*it).batchId());
                 if (!SortUtil::hasEndTime(res) && SortUtil::hasStartTime(res)) {
@@ -549,6 +960,9 @@ void TimelineModel::updateInformationElements()
 
         ++it;
         previousCountry = newCountry;
+        if (isWindowEnd) {
+            break;
+        }
     }
 
     // add DST transition information in a -1/+3 months window, if there are any
@@ -565,12 +979,13 @@ void TimelineModel::updateInformationElements()
             searchWindowEnd = std::min(searchWindowEnd, m_tripGroup.endDateTime());
         }
 
-        for (auto it = m_elements.begin(); it != m_elements.end(); ++it) {
+        // rows before the recomputation window are unchanged by the above
+        for (auto it = m_elements.begin() + windowBeginRow; it != m_elements.end() && (!windowEnd.isValid() || (*it).dateTime() < windowEnd); ++it) {
             if ((*it).isInformational() || (*it).isCanceled()) {
                 continue;
             }
             const auto tz = timeZone((*it).endDateTime());
-            auto startDt = std::max((*it).dt, searchWindowBegin);
+            auto startDt = std::max((*it).dateTime(), searchWindowBegin);
             auto endDt = searchWindowEnd;
             for (auto nextIt = it; std::next(nextIt) != m_elements.end();) {
                 ++nextIt;
@@ -578,14 +993,14 @@ void TimelineModel::updateInformationElements()
                     || ((*nextIt).elementType == TimelineElement::Transfer && (*nextIt).content().value<Transfer>().state() != Transfer::Selected)) {
                     continue;
                 }
-                endDt = std::min(endDt, (*nextIt).dt);
+                endDt = std::min(endDt, (*nextIt).dateTime());
                 break;
             }
-            if (startDt > searchWindowEnd || endDt < searchWindowBegin || !tz.isValid() || !tz.hasTransitions() || !tz.hasDaylightTime()) {
+            if (startDt > searchWindowEnd || endDt < searchWindowBegin || !tz.isValid() || !TimeZoneCache::hasDaylightTimeTransitions(tz)) {
                 continue;
             }
             while (startDt < endDt) {
-                const auto nextTransition = tz.nextTransition(startDt);
+                const auto nextTransition = TimeZoneCache::nextTransition(tz, startDt);
                 if (!nextTransition.atUtc.isValid() || nextTransition.atUtc >= endDt) {
                     break;
                 }
@@ -602,15 +1017,37 @@ void TimelineModel::updateInformationElements()
     updateWeatherElements();
 }
 
-void TimelineModel::updateWeatherElements()
+QList<QVariant> TimelineModel::sortedReservations(const QString &batchId) const
 {
-    if (!m_weatherMgr || !m_weatherMgr->allowNetworkAccess() || m_elements.empty()) {
-        return;
+    auto it = m_sortedReservations.constFind(batchId);
+    if (it != m_sortedReservations.constEnd()) {
+        return it.value();
     }
 
-    qDebug() << "recomputing weather elements";
-    GeoCoordinates geo = LocationUtil::geo(m_initialLocation);
+    const auto resIds = m_resMgr->reservationsForBatch(batchId);
+    QList<QVariant> v;
+    v.reserve(resIds.size());
+    for (const auto &resId : resIds) {
+        v.push_back(m_resMgr->reservation(resId));
+    }
+    std::sort(v.begin(), v.end(), SortUtil::isBefore);
+    m_sortedReservations.insert(batchId, v);
+    return v;
+}
+
+bool TimelineModel::WeatherSlot::hasSameLocationContext(const WeatherSlot &other) const
+{
+    return begin == other.begin && end == other.end && geo == other.geo && label == other.label;
+}
+
+std::vector<TimelineModel::WeatherSlot> TimelineModel::computeWeatherSlots() const
+{
+    std::vector<WeatherSlot> slots;
+    GeoCoordinates geo = LocationUtil::geo(m_windowContextLocation.isValid() ? m_windowContextLocation : m_initialLocation);
     QString label;
+    if (m_windowContextLocation.isValid()) {
+        label = WeatherInformation::labelForPlace(m_windowContextLocation);
+    }
 
     auto date = now();
     if (m_tripGroup.beginDateTime().isValid()) {
@@ -628,19 +1065,10 @@ void TimelineModel::updateWeatherElements()
         maxForecastTime = std::min(maxForecastTime, tgEndOfDay);
     }
 
-    // look through the past, clean up weather elements there and figure out where we are
+    // look through the past and figure out where we are
     auto it = m_elements.begin();
-    for (; it != m_elements.end() && (*it).dt < now();) {
-        if ((*it).elementType == TimelineElement::WeatherForecast) {
-            const auto row = (int)std::distance(m_elements.begin(), it);
-            beginRemoveRows({}, row, row);
-            it = m_elements.erase(it);
-            endRemoveRows();
-            continue;
-        }
-
-        if ((*it).isCanceled()) {
-            ++it;
+    for (; it != m_elements.end() && (*it).dateTime() < now(); ++it) {
+        if ((*it).elementType == TimelineElement::WeatherForecast || (*it).isCanceled()) {
             continue;
         }
         const auto newGeo = LocationUtil::geo((*it).destination());
@@ -654,35 +1082,18 @@ void TimelineModel::updateWeatherElements()
                 date = endDt;
             }
         }
-
-        ++it;
     }
 
     while (it != m_elements.end() && date < maxForecastTime) {
-        if ((*it).dt < date || (*it).elementType == TimelineElement::TodayMarker) {
-            // clean up outdated weather elements (happens when merging previously split ranges)
-            if ((*it).elementType == TimelineElement::WeatherForecast) {
-                const auto row = (int)std::distance(m_elements.begin(), it);
-                beginRemoveRows({}, row, row);
-                it = m_elements.erase(it);
-                endRemoveRows();
-                if (it == m_elements.end()) {
-                    break;
-                }
-                continue;
-            }
-
+        if ((*it).dateTime() < date || (*it).elementType == TimelineElement::TodayMarker || (*it).elementType == TimelineElement::WeatherForecast) {
             // track where we are
-            if ((*it).isCanceled()) {
-                ++it;
-                continue;
-            }
-            const auto newGeo = LocationUtil::geo((*it).destination());
-            if ((*it).isLocationChange() || newGeo.isValid()) {
-                geo = newGeo;
-                label = WeatherInformation::labelForPlace((*it).destination());
+            if ((*it).elementType != TimelineElement::WeatherForecast && !(*it).isCanceled()) {
+                const auto newGeo = LocationUtil::geo((*it).destination());
+                if ((*it).isLocationChange() || newGeo.isValid()) {
+                    geo = newGeo;
+                    label = WeatherInformation::labelForPlace((*it).destination());
+                }
             }
-
             ++it;
             continue;
         }
@@ -694,12 +1105,12 @@ void TimelineModel::updateWeatherElements()
         GeoCoordinates newGeo = geo;
         QString newLabel = label;
         for (auto it2 = it; it2 != m_elements.end(); ++it2) {
-            if ((*it2).dt >= endTime) {
+            if ((*it2).dateTime() >= endTime) {
                 break;
             }
             if ((*it2).isLocationChange() && !(*it2).isCanceled()) {
                 // exclude the actual travel time from forecast ranges
-                endTime = std::min(endTime, (*it2).dt);
+                endTime = std::min(endTime, (*it2).dateTime());
                 nextStartTime = std::max(endTime, (*it2).endDateTime());
                 newGeo = LocationUtil::geo((*it2).destination());
                 newLabel = WeatherInformation::labelForPlace((*it2).destination());
@@ -707,50 +1118,120 @@ void TimelineModel::updateWeatherElements()
             }
         }
 
-        ::WeatherForecast fc;
-        if (geo.isValid()) {
-            m_weatherMgr->monitorLocation(geo.latitude(), geo.longitude());
-            fc = m_weatherMgr->forecast(geo.latitude(), geo.longitude(), date, endTime);
-        }
-
-        // updated or new data
-        if (fc.isValid()) {
-            it = insertOrUpdate(it, TimelineElement{this, TimelineElement::WeatherForecast, date, QVariant::fromValue(WeatherInformation{fc, label})});
-        }
-        // we have no forecast data, but a matching weather element: remove
-        else if ((*it).elementType == TimelineElement::WeatherForecast && (*it).dt == date) {
-            const auto row = (int)std::distance(m_elements.begin(), it);
-            beginRemoveRows({}, row, row);
-            it = m_elements.erase(it);
-            endRemoveRows();
-        }
-
+        slots.push_back({date, endTime, geo, label, {}});
         geo = newGeo;
         label = newLabel;
         date = nextStartTime.addSecs(1);
-        ++it;
     }
 
-    // append weather elements beyond the end of the list if necessary
+    // continue beyond the end of the list if necessary
     while (date < maxForecastTime && geo.isValid()) {
         auto endTime = date;
         endTime.setTime(QTime(23, 59, 59));
+        slots.push_back({date, endTime, geo, label, {}});
+        date = endTime.addSecs(1);
+    }
 
-        m_weatherMgr->monitorLocation(geo.latitude(), geo.longitude());
-        const auto fc = m_weatherMgr->forecast(geo.latitude(), geo.longitude(), date, endTime);
-        if (fc.isValid()) {
-            const auto row = (int)std::distance(m_elements.begin(), it);
-            beginInsertRows({}, row, row);
-            it = m_elements.insert(it, TimelineElement{this, TimelineElement::WeatherForecast, date, QVariant::fromValue(WeatherInformation{fc, label})});
-            ++it;
-            endInsertRows();
+    return slots;
+}
+
+void TimelineModel::updateWeatherElements()
+{
+    if (!m_weatherMgr || !m_weatherMgr->allowNetworkAccess() || m_elements.empty()) {
+        return;
+    }
+
+    qDebug() << "recomputing weather elements";
+    auto slots = computeWeatherSlots();
+
+    // only query forecasts and touch rows for time ranges with a changed location context
+    auto oldIt = m_weatherSlots.begin();
+    for (auto &slot : slots) {
+        oldIt = std::lower_bound(oldIt, m_weatherSlots.end(), slot.begin, [](const auto &lhs, const auto &rhs) {
+            return lhs.begin < rhs;
+        });
+        if (oldIt != m_weatherSlots.end() && (*oldIt).hasSameLocationContext(slot)) {
+            slot.forecast = (*oldIt).forecast;
+            continue;
+        }
+        updateWeatherSlot(slot);
+    }
+
+    // remove elements of time ranges that no longer exist (eg. the past, or after merging previously split ranges)
+    for (const auto &oldSlot : m_weatherSlots) {
+        const auto newIt = std::lower_bound(slots.begin(), slots.end(), oldSlot.begin, [](const auto &lhs, const auto &rhs) {
+            return lhs.begin < rhs;
+        });
+        if (newIt == slots.end() || (*newIt).begin != oldSlot.begin) {
+            removeWeatherElement(oldSlot.begin);
         }
-        date = endTime.addSecs(1);
     }
 
+    m_weatherSlots = std::move(slots);
     qDebug() << "weather recomputation done";
 }
 
+void TimelineModel::weatherTilesUpdated(const std::vector<WeatherTile> &tiles)
+{
+    if (!m_weatherMgr || !m_weatherMgr->allowNetworkAccess() || m_elements.empty()) {
+        return;
+    }
+    // nothing computed yet, eg. due to network access having been disabled so far
+    if (m_weatherSlots.empty()) {
+        updateWeatherElements();
+        return;
+    }
+
+    for (auto &slot : m_weatherSlots) {
+        if (!slot.geo.isValid() || std::find(tiles.begin(), tiles.end(), WeatherTile{slot.geo.latitude(), slot.geo.longitude()}) == tiles.end()) {
+            continue;
+        }
+        updateWeatherSlot(slot);
+    }
+}
+
+void TimelineModel::updateWeatherSlot(WeatherSlot &slot)
+{
+    slot.forecast = {};
+    if (slot.geo.isValid()) {
+        m_weatherMgr->monitorLocation(slot.geo.latitude(), slot.geo.longitude());
+        slot.forecast = m_weatherMgr->forecast(slot.geo.latitude(), slot.geo.longitude(), slot.begin, slot.end);
+    }
+
+    // we have no forecast data, but possibly a matching weather element: remove
+    if (!slot.forecast.isValid()) {
+        removeWeatherElement(slot.begin);
+        return;
+    }
+
+    TimelineElement elem{this, TimelineElement::WeatherForecast, slot.begin, QVariant::fromValue(WeatherInformation{slot.forecast, slot.label})};
+    if (const auto row = weatherRow(slot.begin); row >= 0) {
+        m_elements[row] = std::move(elem);
+        Q_EMIT dataChanged(index(row, 0), index(row, 0));
+    } else {
+        insertElement(std::move(elem));
+    }
+}
+
+int TimelineModel::weatherRow(const QDateTime &dt) const
+{
+    for (auto it = std::lower_bound(m_elements.begin(), m_elements.end(), dt); it != m_elements.end() && (*it).dateTime() == dt; ++it) {
+        if ((*it).elementType == TimelineElement::WeatherForecast) {
+            return (int)std::distance(m_elements.begin(), it);
+        }
+    }
+    return -1;
+}
+
+void TimelineModel::removeWeatherElement(const QDateTime &dt)
+{
+    if (const auto row = weatherRow(dt); row >= 0) {
+        beginRemoveRows({}, row, row);
+        m_elements.erase(m_elements.begin() + row);
+        endRemoveRows();
+    }
+}
+
 void TimelineModel::updateTransfersForBatch(const QString &batchId)
 {
     if (!m_transferManager) {
@@ -826,7 +1307,14 @@ void TimelineModel::tripGroupRemoved(const QString &groupId)
     if (m_isPopulated && m_tripGroupId == groupId) {
         beginResetModel();
         m_elements.clear();
+        m_todayMarkerDt = {};
+        m_weatherSlots.clear();
+        m_sortedReservations.clear();
         m_isPopulated = false;
+        m_isPrefetched = false;
+        m_prefetchBatchIds.clear();
+        m_windowBegin = {};
+        m_windowEnd = {};
         endResetModel();
     }
 }
@@ -841,12 +1329,11 @@ void TimelineModel::transferChanged(const Transfer &transfer)
         return;
     }
 
-    auto it = std::find_if(m_elements.begin(), m_elements.end(), [transfer](const auto &e) {
-        return e.isReservation() && e.batchId() == transfer.reservationId();
-    });
-    if (it == m_elements.end()) {
+    const auto row = firstRowForReservation(transfer.reservationId());
+    if (row < 0) {
         return;
     }
+    auto it = m_elements.begin() + row;
 
     TimelineElement elem(this, transfer);
     if (transfer.alignment() == Transfer::Before) {
@@ -869,16 +1356,13 @@ void TimelineModel::transferRemoved(const QString &resId, Transfer::Alignment al
         return;
     }
 
-    auto it = std::find_if(m_elements.begin(), m_elements.end(), [resId, alignment](const auto &e) {
-        return e.elementType == TimelineElement::Transfer && e.batchId() == resId && e.content().template value<Transfer>().alignment() == alignment;
-    });
-    if (it == m_elements.end()) {
+    const auto row = rowForTransfer(resId, alignment);
+    if (row < 0) {
         return;
     }
 
-    const auto row = (int)std::distance(m_elements.begin(), it);
     beginRemoveRows({}, row, row);
-    m_elements.erase(it);
+    m_elements.erase(m_elements.begin() + row);
     endRemoveRows();
 
     Q_EMIT todayRowChanged();
@@ -887,17 +1371,136 @@ void TimelineModel::transferRemoved(const QString &resId, Transfer::Alignment al
 bool TimelineModel::isDateEmpty(const QDate &date) const
 {
     auto it = std::lower_bound(m_elements.begin(), m_elements.end(), date, [](const auto &lhs, auto rhs) {
-        return lhs.dt.date() < rhs;
+        return lhs.dateTime().date() < rhs;
     });
     for (; it != m_elements.end(); ++it) {
-        if ((*it).dt.date() == date && (*it).elementType != TimelineElement::TodayMarker) {
+        if ((*it).dateTime().date() == date && (*it).elementType != TimelineElement::TodayMarker) {
             return false;
         }
-        if ((*it).dt.date() != date) {
+        if ((*it).dateTime().date() != date) {
             break;
         }
     }
     return true;
 }
 
+int TimelineModel::rowForReservation(const QString &batchId, TimelineElement::RangeType rangeType) const
+{
+    ensureRowIndex();
+    const auto it = m_rowIndex.constFind(batchId);
+    if (it == m_rowIndex.constEnd()) {
+        return -1;
+    }
+    return indexedRow((*it).reservationTimes[rangeType], [&batchId, rangeType](const TimelineElement &elem) {
+        return elem.isReservation() && elem.rangeType == rangeType && elem.batchId() == batchId;
+    });
+}
+
+int TimelineModel::firstRowForReservation(const QString &batchId) const
+{
+    int row = -1;
+    for (const auto rangeType : {TimelineElement::SelfContained, TimelineElement::RangeBegin, TimelineElement::RangeEnd}) {
+        if (const auto r = rowForReservation(batchId, rangeType); r >= 0 && (row < 0 || r < row)) {
+            row = r;
+        }
+    }
+    return row;
+}
+
+int TimelineModel::rowForTransfer(const QString &batchId, Transfer::Alignment alignment) const
+{
+    ensureRowIndex();
+    const auto it = m_rowIndex.constFind(batchId);
+    if (it == m_rowIndex.constEnd()) {
+        return -1;
+    }
+    return indexedRow((*it).transferTimes[alignment], [&batchId, alignment](const TimelineElement &elem) {
+        if (elem.elementType != TimelineElement::Transfer) {
+            return false;
+        }
+        const auto transfer = elem.content().value<Transfer>();
+        return transfer.alignment() == alignment && transfer.reservationId() == batchId;
+    });
+}
+
+int TimelineModel::indexedRow(const std::optional<QDateTime> &dt, const std::function<bool(const TimelineElement &)> &isElement) const
+{
+    if (!dt) {
+        return -1;
+    }
+
+    // only elements at exactly the same time need to be checked
+    for (auto it = std::lower_bound(m_elements.begin(), m_elements.end(), *dt); it != m_elements.end() && (*it).dateTime() == *dt; ++it) {
+        if (isElement(*it)) {
+            return (int)std::distance(m_elements.begin(), it);
+        }
+    }
+
+    // in-place updates of transfers can leave an element slightly out of order
+    const auto it = std::find_if(m_elements.begin(), m_elements.end(), isElement);
+    return it != m_elements.end() ? (int)std::distance(m_elements.begin(), it) : -1;
+}
+
+void TimelineModel::invalidateRowIndex()
+{
+    m_rowIndexValid = false;
+}
+
+void TimelineModel::ensureRowIndex() const
+{
+    if (m_rowIndexValid) {
+        return;
+    }
+
+    m_rowIndex.clear();
+    m_rowIndex.reserve((qsizetype)m_elements.size());
+    for (const auto &elem : m_elements) {
+        if (auto slot = rowIndexSlot(elem); slot && !*slot) {
+            *slot = elem.dateTime();
+        }
+    }
+    m_rowIndexValid = true;
+}
+
+std::optional<QDateTime> *TimelineModel::rowIndexSlot(const TimelineElement &elem) const
+{
+    if (elem.isReservation()) {
+        return &m_rowIndex[elem.batchId()].reservationTimes[elem.rangeType];
+    }
+    if (elem.elementType == TimelineElement::Transfer) {
+        const auto transfer = elem.content().value<Transfer>();
+        return &m_rowIndex[transfer.reservationId()].transferTimes[transfer.alignment()];
+    }
+    return nullptr;
+}
+
+void TimelineModel::rowIndexRowsInserted(int first, int last)
+{
+    if (!m_rowIndexValid) {
+        return;
+    }
+
+    for (int row = first; row <= last; ++row) {
+        const auto &elem = m_elements[row];
+        if (auto slot = rowIndexSlot(elem); slot && (!*slot || elem.dateTime() < **slot)) {
+            *slot = elem.dateTime();
+        }
+    }
+}
+
+void TimelineModel::rowIndexRowsAboutToBeRemoved(int first, int last)
+{
+    if (!m_rowIndexValid) {
+        return;
+    }
+
+    // the elements are still there at this point, so we can find their entries
+    for (int row = first; row <= last; ++row) {
+        const auto &elem = m_elements[row];
+        if (auto slot = rowIndexSlot(elem); slot && *slot && **slot == elem.dateTime()) {
+            slot->reset();
+        }
+    }
+}
+
 #include "moc_timelinemodel.cpp"
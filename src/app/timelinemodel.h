@@ -10,12 +10,20 @@
 #include "timelineelement.h"
 #include "transfer.h"
 #include "tripgroup.h"
+#include "weatherforecast.h"
+#include "weathertile.h"
+
+#include <KItinerary/Place>
 
 #include <QAbstractListModel>
+#include <QChronoTimer>
 #include <QDateTime>
 #include <QTimer>
 #include <qqmlregistration.h>
 
+#include <functional>
+#include <optional>
+
 class ReservationManager;
 class WeatherForecastManager;
 class TripGroupManager;
@@ -41,6 +49,14 @@ class TimelineModel : public QAbstractListModel
      */
     Q_PROPERTY(QVariant initialLocation MEMBER m_initialLocation NOTIFY initialLocationChanged)
 
+    /** Only create elements for a time window around the current date (or the start of
+     *  the trip for trips in the future), rather than for the entire trip group.
+     *  The window is extended on demand by fetchMore() and fetchEarlier().
+     */
+    Q_PROPERTY(bool windowed MEMBER m_windowed WRITE setWindowed NOTIFY setupChanged)
+    /** There are elements before the current time window. */
+    Q_PROPERTY(bool canFetchEarlier READ canFetchEarlier NOTIFY windowChanged)
+
 public:
     enum Role {
         SectionHeaderRole = Qt::UserRole + 1,
@@ -57,6 +73,7 @@ public:
         EndDateTimeRole,
         IsTimeboxedRole,
         IsCanceledRole,
+        IsCurrentRole, ///< the element has started but not ended yet
     };
     Q_ENUM(Role)
 
@@ -70,12 +87,21 @@ public:
     void setHomeCountryIsoCode(const QString &isoCode);
     void setTransferManager(TransferManager *mgr);
     void setTripGroupId(const QString &tgId);
+    void setWindowed(bool windowed);
 
     [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override;
     [[nodiscard]] int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     [[nodiscard]] QHash<int, QByteArray> roleNames() const override;
 
+    [[nodiscard]] bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    [[nodiscard]] bool canFetchEarlier() const;
+    /** Extend the time window in windowed mode to include earlier elements. */
+    Q_INVOKABLE void fetchEarlier();
+
     [[nodiscard]] int todayRow() const;
+    /** The first row with an element starting at or after @p dt, rowCount() if there is none. */
+    Q_INVOKABLE [[nodiscard]] int firstRowAtOrAfter(const QDateTime &dt) const;
 
     // for unit testing
     void setCurrentDateTime(const QDateTime &dt);
@@ -87,12 +113,21 @@ Q_SIGNALS:
     void todayRowChanged();
     void tripGroupIdChanged();
     void initialLocationChanged();
+    void windowChanged();
 
 private:
     void populate();
     void populateReservation(const QString &resId);
 
+    /** Time window handling. */
+    void resetWindow(const TripGroup &tg);
+    [[nodiscard]] bool isInWindow(const QString &batchId) const;
+    [[nodiscard]] QStringList batchesInWindow(const QStringList &batchIds) const;
+    void extendWindow(const QDateTime &begin, const QDateTime &end);
+    void updateWindowContext();
+
     void batchAdded(const QString &resId);
+    void insertReservation(const QString &resId, QDateTime &changeBegin, QDateTime &changeEnd);
     int insertElement(TimelineElement &&elem);
     std::vector<TimelineElement>::iterator insertOrUpdate(std::vector<TimelineElement>::iterator it, TimelineElement &&elem);
     void batchChanged(const QString &resId);
@@ -107,26 +142,98 @@ private:
 
     void dayChanged();
     void updateTodayMarker();
+    /** Schedule an update for the next time an element starts or ends. */
+    void scheduleTransitionUpdate();
+    /** Update rows whose elements started or ended since the last check. */
+    void transitionReached();
     void updateInformationElements();
+    /** Update information elements after a change affecting the time range [@p changeBegin, @p changeEnd].
+     *  Falls back to a full update if the range is invalid.
+     */
+    void updateInformationElements(const QDateTime &changeBegin, const QDateTime &changeEnd);
     void updateWeatherElements();
+    void weatherTilesUpdated(const std::vector<WeatherTile> &tiles);
     void updateTransfersForBatch(const QString &batchId);
 
     [[nodiscard]] bool isDateEmpty(const QDate &date) const;
 
+    /** Row lookup for reservation and transfer elements, -1 if not found.
+     *  Based on an index from batch id to the time of the corresponding elements, that is
+     *  built on demand and then kept up to date when elements are inserted or removed.
+     *  Rows are then found by binary search, so the index doesn't depend on row numbers.
+     */
+    [[nodiscard]] int rowForReservation(const QString &batchId, TimelineElement::RangeType rangeType) const;
+    /** The first row for the given batch id, ie. the start of a split element. */
+    [[nodiscard]] int firstRowForReservation(const QString &batchId) const;
+    [[nodiscard]] int rowForTransfer(const QString &batchId, Transfer::Alignment alignment) const;
+    /** Row of the element at time @p dt matching @p isElement, -1 if not found. */
+    [[nodiscard]] int indexedRow(const std::optional<QDateTime> &dt, const std::function<bool(const TimelineElement &)> &isElement) const;
+    void invalidateRowIndex();
+    void ensureRowIndex() const;
+    /** The row index entry for @p elem, or @c nullptr for elements that aren't indexed. */
+    [[nodiscard]] std::optional<QDateTime> *rowIndexSlot(const TimelineElement &elem) const;
+    void rowIndexRowsInserted(int first, int last);
+    void rowIndexRowsAboutToBeRemoved(int first, int last);
+
+    /** All reservations of @p batchId in display order, cached until the batch changes. */
+    [[nodiscard]] QList<QVariant> sortedReservations(const QString &batchId) const;
+
+    /** A time range with a weather forecast for a fixed location. */
+    struct WeatherSlot {
+        QDateTime begin;
+        QDateTime end;
+        KItinerary::GeoCoordinates geo;
+        QString label;
+        WeatherForecast forecast;
+
+        [[nodiscard]] bool hasSameLocationContext(const WeatherSlot &other) const;
+    };
+    /** Computes the weather forecast time ranges for the current content, without retrieving forecasts. */
+    [[nodiscard]] std::vector<WeatherSlot> computeWeatherSlots() const;
+    /** Retrieves the forecast for @p slot and updates, inserts or removes the corresponding weather element. */
+    void updateWeatherSlot(WeatherSlot &slot);
+    [[nodiscard]] int weatherRow(const QDateTime &dt) const;
+    void removeWeatherElement(const QDateTime &dt);
+
     friend class TimelineElement;
     ReservationManager *m_resMgr = nullptr;
     WeatherForecastManager *m_weatherMgr = nullptr;
     TripGroupManager *m_tripGroupManager = nullptr;
     TransferManager *m_transferManager = nullptr;
     std::vector<TimelineElement> m_elements;
+
+    struct RowIndexEntry {
+        std::optional<QDateTime> reservationTimes[3]; // indexed by TimelineElement::RangeType
+        std::optional<QDateTime> transferTimes[2]; // indexed by Transfer::Alignment
+    };
+    mutable QHash<QString, RowIndexEntry> m_rowIndex;
+    mutable bool m_rowIndexValid = false;
+    mutable QHash<QString, QList<QVariant>> m_sortedReservations;
+
+    /** Weather forecast ranges currently represented in the model, sorted by begin time. */
+    std::vector<WeatherSlot> m_weatherSlots;
+
     QString m_tripGroupId;
     TripGroup m_tripGroup;
     QString m_homeCountry;
     QVariant m_initialLocation;
     QDateTime m_unitTestTime;
     QTimer m_dayUpdateTimer;
+    QChronoTimer m_transitionTimer;
+    QDateTime m_lastTransitionCheck;
+    // position of the today marker, for finding its row by binary search
+    QDateTime m_todayMarkerDt;
     bool m_todayEmpty = true;
     bool m_isPopulated = false;
+    QStringList m_prefetchBatchIds;
+    bool m_isPrefetched = false;
+
+    bool m_windowed = false;
+    QDateTime m_windowBegin;
+    QDateTime m_windowEnd;
+    // destination and arrival time of the last location change before the window
+    QVariant m_windowContextLocation;
+    QDateTime m_windowContextTime;
 };
 
 #endif // TIMELINEMODEL_H
@@ -0,0 +1,181 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "timezonecache.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+
+#include <algorithm>
+#include <vector>
+
+// transition tables are extended by at least this around a queried time
+constexpr qint64 CoverageMSecs = 400ll * 24 * 3600 * 1000;
+
+namespace
+{
+struct Transition {
+    qint64 atMSecs;
+    QTimeZone::OffsetData data;
+};
+
+struct ZoneTable {
+    QTimeZone tz;
+    bool hasTransitions = false;
+    bool hasDaylightTime = false;
+
+    // covered time range [begin, end[ in msecs since epoch, empty if nothing loaded yet
+    qint64 begin = 0;
+    qint64 end = 0;
+    // state at begin, before the first transition
+    QTimeZone::OffsetData initial;
+    std::vector<Transition> transitions;
+};
+
+struct Cache {
+    QMutex mutex;
+    QHash<QByteArray, QTimeZone> timeZones;
+    QHash<QByteArray, ZoneTable> tables;
+};
+}
+
+[[nodiscard]] static Cache &cache()
+{
+    static Cache c;
+    return c;
+}
+
+[[nodiscard]] static ZoneTable &zoneTable(Cache &c, const QTimeZone &tz)
+{
+    const auto id = tz.id();
+    auto it = c.tables.find(id);
+    if (it == c.tables.end()) {
+        ZoneTable table;
+        table.tz = tz;
+        table.hasTransitions = tz.hasTransitions();
+        table.hasDaylightTime = tz.hasDaylightTime();
+        it = c.tables.insert(id, std::move(table));
+    }
+    return it.value();
+}
+
+static void ensureCovered(ZoneTable &table, qint64 t)
+{
+    const bool isEmpty = table.begin >= table.end;
+    if (!isEmpty && t >= table.begin && t < table.end) {
+        return;
+    }
+
+    const auto begin = isEmpty ? t - CoverageMSecs : std::min(table.begin, t - CoverageMSecs);
+    const auto end = isEmpty ? t + CoverageMSecs : std::max(table.end, t + CoverageMSecs);
+    const auto beginDt = QDateTime::fromMSecsSinceEpoch(begin, QTimeZone::UTC);
+    table.initial = table.tz.offsetData(beginDt);
+    table.transitions.clear();
+    const auto transitions = table.tz.transitions(beginDt, QDateTime::fromMSecsSinceEpoch(end, QTimeZone::UTC));
+    table.transitions.reserve(transitions.size());
+    for (const auto &transition : transitions) {
+        table.transitions.push_back({transition.atUtc.toMSecsSinceEpoch(), transition});
+    }
+    table.begin = begin;
+    table.end = end;
+}
+
+[[nodiscard]] static bool isCacheable(const QTimeZone &tz)
+{
+    return tz.isValid() && tz.timeSpec() == Qt::TimeZone;
+}
+
+QTimeZone TimeZoneCache::timeZone(const QByteArray &ianaId)
+{
+    if (ianaId.isEmpty()) {
+        return {};
+    }
+
+    auto &c = cache();
+    QMutexLocker locker(&c.mutex);
+    auto it = c.timeZones.find(ianaId);
+    if (it == c.timeZones.end()) {
+        it = c.timeZones.insert(ianaId, QTimeZone(ianaId));
+    }
+    return it.value();
+}
+
+QTimeZone::OffsetData TimeZoneCache::offsetData(const QTimeZone &tz, const QDateTime &dt)
+{
+    if (!isCacheable(tz) || !dt.isValid()) {
+        return tz.offsetData(dt);
+    }
+
+    auto &c = cache();
+    QMutexLocker locker(&c.mutex);
+    auto &table = zoneTable(c, tz);
+    if (!table.hasTransitions) {
+        return tz.offsetData(dt);
+    }
+
+    const auto t = dt.toMSecsSinceEpoch();
+    ensureCovered(table, t);
+    const auto it = std::upper_bound(table.transitions.begin(), table.transitions.end(), t, [](qint64 lhs, const auto &rhs) {
+        return lhs < rhs.atMSecs;
+    });
+    auto data = it == table.transitions.begin() ? table.initial : (*std::prev(it)).data;
+    data.atUtc = dt.toUTC();
+    return data;
+}
+
+int TimeZoneCache::offsetFromUtc(const QTimeZone &tz, const QDateTime &dt)
+{
+    const auto data = offsetData(tz, dt);
+    return data.offsetFromUtc == QTimeZone::invalidSeconds() ? 0 : data.offsetFromUtc;
+}
+
+QString TimeZoneCache::abbreviation(const QTimeZone &tz, const QDateTime &dt)
+{
+    return offsetData(tz, dt).abbreviation;
+}
+
+bool TimeZoneCache::isDaylightTime(const QTimeZone &tz, const QDateTime &dt)
+{
+    const auto data = offsetData(tz, dt);
+    return data.daylightTimeOffset != QTimeZone::invalidSeconds() && data.daylightTimeOffset != 0;
+}
+
+bool TimeZoneCache::hasDaylightTimeTransitions(const QTimeZone &tz)
+{
+    if (!isCacheable(tz)) {
+        return tz.hasDaylightTime() && tz.hasTransitions();
+    }
+
+    auto &c = cache();
+    QMutexLocker locker(&c.mutex);
+    const auto &table = zoneTable(c, tz);
+    return table.hasDaylightTime && table.hasTransitions;
+}
+
+QTimeZone::OffsetData TimeZoneCache::nextTransition(const QTimeZone &tz, const QDateTime &dt)
+{
+    if (!isCacheable(tz) || !dt.isValid()) {
+        return tz.nextTransition(dt);
+    }
+
+    auto &c = cache();
+    QMutexLocker locker(&c.mutex);
+    auto &table = zoneTable(c, tz);
+    if (!table.hasTransitions) {
+        return tz.nextTransition(dt);
+    }
+
+    const auto t = dt.toMSecsSinceEpoch();
+    ensureCovered(table, t);
+    const auto it = std::upper_bound(table.transitions.begin(), table.transitions.end(), t, [](qint64 lhs, const auto &rhs) {
+        return lhs < rhs.atMSecs;
+    });
+    if (it != table.transitions.end()) {
+        return (*it).data;
+    }
+    // beyond the cached range, might be far in the future or not exist at all
+    return tz.nextTransition(dt);
+}
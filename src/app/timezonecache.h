@@ -0,0 +1,42 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef TIMEZONECACHE_H
+#define TIMEZONECACHE_H
+
+#include <QTimeZone>
+
+class QByteArray;
+class QDateTime;
+class QString;
+
+/** Process-wide cache of time zone transition tables.
+ *  QTimeZone queries go to the ICU/tzdata backend on every call, which adds up
+ *  when done for every timeline element or formatted time. This instead loads
+ *  the transitions of a time zone once for the range of a few years around the
+ *  times queried and answers offset and transition lookups from that.
+ *
+ *  Results match the corresponding QTimeZone methods. This is thread-safe.
+ */
+namespace TimeZoneCache
+{
+/** Returns the time zone for the IANA id @p ianaId, without creating a new backend instance each time. */
+[[nodiscard]] QTimeZone timeZone(const QByteArray &ianaId);
+
+/** Same as QTimeZone::offsetData(). */
+[[nodiscard]] QTimeZone::OffsetData offsetData(const QTimeZone &tz, const QDateTime &dt);
+/** Same as QTimeZone::offsetFromUtc(). */
+[[nodiscard]] int offsetFromUtc(const QTimeZone &tz, const QDateTime &dt);
+/** Same as QTimeZone::abbreviation(). */
+[[nodiscard]] QString abbreviation(const QTimeZone &tz, const QDateTime &dt);
+/** Same as QTimeZone::isDaylightTime(). */
+[[nodiscard]] bool isDaylightTime(const QTimeZone &tz, const QDateTime &dt);
+/** Same as QTimeZone::hasDaylightTime() && QTimeZone::hasTransitions(). */
+[[nodiscard]] bool hasDaylightTimeTransitions(const QTimeZone &tz);
+/** Same as QTimeZone::nextTransition(). */
+[[nodiscard]] QTimeZone::OffsetData nextTransition(const QTimeZone &tz, const QDateTime &dt);
+}
+
+#endif // TIMEZONECACHE_H
@@ -5,15 +5,13 @@
 */
 
 #include "transferdelegatecontroller.h"
+#include "deadlinescheduler.h"
 
 #include <QDebug>
 
 TransferDelegateController::TransferDelegateController(QObject *parent)
     : QObject(parent)
 {
-    m_updateTrigger.setTimerType(Qt::VeryCoarseTimer);
-    connect(&m_updateTrigger, &QChronoTimer::timeout, this, &TransferDelegateController::updated);
-    connect(&m_updateTrigger, &QChronoTimer::timeout, this, &TransferDelegateController::scheduleTimer);
 }
 
 TransferDelegateController::~TransferDelegateController() = default;
@@ -30,7 +28,7 @@ void TransferDelegateController::setTransfer(const Transfer &transfer)
     Q_EMIT updated();
 
     if (transfer.state() != Transfer::Selected) {
-        m_updateTrigger.stop();
+        DeadlineScheduler::instance()->cancel(this);
         return;
     }
 
@@ -73,18 +71,22 @@ void TransferDelegateController::scheduleTimer()
     const auto now = QDateTime::currentDateTime();
 
     if ((jny.hasExpectedArrivalTime() && jny.expectedArrivalTime() < now) || jny.scheduledArrivalTime() < now) { // already arrived
-        m_updateTrigger.stop();
+        DeadlineScheduler::instance()->cancel(this);
         return;
     }
+
+    const auto update = [this]() {
+        Q_EMIT updated();
+        scheduleTimer();
+    };
     const auto depTime = jny.departureDelay() < 0 ? jny.expectedDepartureTime() : jny.scheduledDepartureTime();
     if (now < depTime) {
-        m_updateTrigger.setInterval(std::chrono::seconds(now.secsTo(depTime)));
-        m_updateTrigger.start();
+        DeadlineScheduler::instance()->schedule(this, depTime, update, std::chrono::seconds(5));
         return;
     }
 
-    m_updateTrigger.setInterval(std::chrono::minutes(1));
-    m_updateTrigger.start();
+    // progress updates, aligned to full minutes so all ongoing transfers update together
+    DeadlineScheduler::instance()->schedule(this, now.addSecs(1), update, std::chrono::minutes(1));
 }
 
 #include "moc_transferdelegatecontroller.cpp"
@@ -9,7 +9,6 @@
 
 #include "transfer.h"
 
-#include <QChronoTimer>
 #include <QObject>
 #include <qqmlregistration.h>
 
@@ -41,7 +40,6 @@ private:
     void scheduleTimer();
 
     Transfer m_transfer;
-    QChronoTimer m_updateTrigger;
 };
 
 #endif // TRANSFERDELEGATECONTROLLER_H
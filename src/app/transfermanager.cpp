@@ -8,6 +8,7 @@
 
 #include "constants.h"
 #include "favoritelocationmodel.h"
+#include "filewritequeue.h"
 #include "jsonio.h"
 #include "livedatamanager.h"
 #include "logging.h"
@@ -216,7 +217,8 @@ void TransferManager::rescan(bool force)
     }
 
     qCInfo(Log) << "Performing a full transfer search..." << previousFullScanVersion;
-    for (const auto &batchId : m_resMgr->batches()) {
+    // transfers anchored in the past are never added, so only ongoing and future batches matter
+    for (const auto &batchId : m_resMgr->batchesInRange(currentDateTime(), {})) {
         checkReservation(batchId);
     }
     settings.setValue(QStringLiteral("FullScan"), CurrentFullScanVersion);
@@ -714,6 +716,7 @@ static QString transferBasePath()
 
 Transfer TransferManager::readFromFile(const QString &resId, Transfer::Alignment alignment) const
 {
+    FileWriteQueue::flush();
     const QString fileName = transferBasePath() + Transfer::identifier(resId, alignment) + QLatin1StringView(".json");
     QFile f(fileName);
     if (!f.open(QFile::ReadOnly)) {
@@ -724,20 +727,14 @@ Transfer TransferManager::readFromFile(const QString &resId, Transfer::Alignment
 
 void TransferManager::writeToFile(const Transfer &transfer) const
 {
-    QDir().mkpath(transferBasePath());
     const QString fileName = transferBasePath() + transfer.identifier() + QLatin1StringView(".json");
-    QFile f(fileName);
-    if (!f.open(QFile::WriteOnly)) {
-        qCWarning(Log) << "Failed to store transfer data" << f.fileName() << f.errorString();
-        return;
-    }
-    f.write(JsonIO::write(Transfer::toJson(transfer)));
+    FileWriteQueue::write(fileName, JsonIO::write(Transfer::toJson(transfer)));
 }
 
 void TransferManager::removeFile(const QString &resId, Transfer::Alignment alignment) const
 {
     const QString fileName = transferBasePath() + Transfer::identifier(resId, alignment) + QLatin1StringView(".json");
-    QFile::remove(fileName);
+    FileWriteQueue::remove(fileName);
 }
 
 void TransferManager::importTransfer(const Transfer &transfer)
@@ -832,6 +829,7 @@ void TransferManager::overrideCurrentDateTime(const QDateTime &dt)
 
 void TransferManager::clear()
 {
+    FileWriteQueue::flush();
     QDir d(transferBasePath());
     qCInfo(Log) << "deleting" << transferBasePath();
     d.removeRecursively();
@@ -6,6 +6,7 @@
 
 #include "tripgroup.h"
 
+#include "filewritequeue.h"
 #include "jsonio.h"
 #include "logging.h"
 #include "transfer.h"
@@ -115,13 +116,7 @@ bool TripGroup::load(const QString &path)
 
 void TripGroup::store(const QString &path) const
 {
-    QFile f(path);
-    if (!f.open(QFile::WriteOnly)) {
-        qCWarning(Log) << "Failed to open trip group file:" << path << f.errorString();
-        return;
-    }
-
-    f.write(JsonIO::write(TripGroup::toJson(*this)));
+    FileWriteQueue::write(path, JsonIO::write(TripGroup::toJson(*this)));
 }
 
 QString TripGroup::slugName() const
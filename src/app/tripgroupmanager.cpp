@@ -6,8 +6,10 @@
 
 #include "tripgroupmanager.h"
 #include "constants.h"
+#include "filewritequeue.h"
 #include "logging.h"
 #include "reservationmanager.h"
+#include "startuptrace.h"
 #include "transfermanager.h"
 #include "tripgroup.h"
 
@@ -25,7 +27,9 @@
 #include <QStandardPaths>
 #include <QUuid>
 
+#include <algorithm>
 #include <set>
+#include <utility>
 
 using namespace Qt::Literals::StringLiterals;
 using namespace KItinerary;
@@ -53,6 +57,7 @@ void TripGroupManager::setReservationManager(ReservationManager *resMgr)
     connect(m_resMgr, &ReservationManager::batchContentChanged, this, &TripGroupManager::batchContentChanged);
     connect(m_resMgr, &ReservationManager::batchRemoved, this, &TripGroupManager::batchRemoved);
     connect(m_resMgr, &ReservationManager::batchRenamed, this, &TripGroupManager::batchRenamed);
+    connect(m_resMgr, &ReservationManager::batchesChanged, this, &TripGroupManager::batchesChanged);
 
     if (m_resMgr && m_transferMgr) {
         checkConsistency();
@@ -131,6 +136,7 @@ QString TripGroupManager::fileForGroup(QStringView tgId)
 
 void TripGroupManager::load()
 {
+    FileWriteQueue::flush();
     const auto base = basePath();
     QDir::root().mkpath(base);
 
@@ -173,15 +179,14 @@ void TripGroupManager::removeTripGroup(const QString &groupId)
         }
     }
     m_tripGroups.erase(groupIt);
-    if (!QFile::remove(fileForGroup(groupId))) {
-        qCWarning(Log) << "Failed to delete trip group file!" << groupId;
-    }
+    FileWriteQueue::remove(fileForGroup(groupId));
     Q_EMIT tripGroupRemoved(groupId);
 }
 
 void TripGroupManager::clear()
 {
     qCDebug(Log) << "deleting" << basePath();
+    FileWriteQueue::flush();
     QDir d(basePath());
     d.removeRecursively();
 }
@@ -228,8 +233,18 @@ void TripGroupManager::removeReservationsInGroup(const QString &groupId)
 
 void TripGroupManager::batchAdded(const QString &resId)
 {
-    // ### we can optimize this by only scanning it +/- MaximumTripElements
-    scanAll();
+    m_pendingScanBatches.push_back(resId);
+    // bulk updates are handled once at the end in batchesChanged()
+    if (m_resMgr->isBulkUpdateInProgress()) {
+        return;
+    }
+    scanPending();
+}
+
+void TripGroupManager::batchesChanged(const QStringList &batchIds)
+{
+    m_pendingScanBatches += batchIds;
+    scanPending();
 }
 
 void TripGroupManager::batchContentChanged(const QString &resId)
@@ -247,7 +262,8 @@ void TripGroupManager::batchContentChanged(const QString &resId)
         tg.store(fileForGroup(tgId));
         Q_EMIT tripGroupChanged(tgId);
     } else {
-        // ### we can probably make this more efficient
+        // the remaining group might fall apart without resId, so rescan around that as well
+        m_pendingScanBatches += tg.elements();
         batchRemoved(resId);
         batchAdded(resId);
     }
@@ -294,6 +310,9 @@ void TripGroupManager::batchRemoved(const QString &resId)
             removeTripGroup(groupId);
         } else { // group changed
             qDebug() << "removing element from trip group" << resId << elems;
+            if (m_resMgr->isBulkUpdateInProgress()) {
+                m_pendingScanBatches += elems;
+            }
             groupIt.value().setElements(elems);
             recomputeTripGroupTimes(groupIt.value());
             groupIt.value().store(fileForGroup(mapIt.value()));
@@ -336,6 +355,8 @@ void TripGroupManager::scanAll()
         m_shouldScan = true;
         return;
     }
+    StartupTrace::Phase tracePhase("TripGroupManager::scanAll");
+    m_pendingScanBatches.clear();
 
     if (!hasUngroupedReservations()) {
         return;
@@ -358,6 +379,86 @@ void TripGroupManager::scanAll()
     m_reservations.clear();
 }
 
+void TripGroupManager::scanAround(const QStringList &batchIds)
+{
+    if (m_suspended) {
+        m_shouldScan = true;
+        return;
+    }
+
+    std::vector<qsizetype> changed;
+    changed.reserve(batchIds.size());
+    bool hasUngrouped = false;
+    for (const auto &batchId : batchIds) {
+        if (const auto idx = m_resMgr->indexOfBatch(batchId); idx >= 0) {
+            changed.push_back(idx);
+            hasUngrouped |= !m_reservationToGroupMap.contains(batchId);
+        }
+    }
+    // same as in scanAll(), nothing to do if everything is grouped already
+    if (!hasUngrouped) {
+        return;
+    }
+    std::ranges::sort(changed);
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+    qCDebug(Log) << "rescanning around" << changed.size() << "changed batches";
+    m_reservations = m_resMgr->batches();
+    const auto groupAt = [this](qsizetype idx) {
+        return m_reservationToGroupMap.value(m_reservations[idx]);
+    };
+
+    qsizetype scanEnd = 0; // everything before this has been scanned already
+    auto changedIt = changed.begin();
+    while (changedIt != changed.end()) {
+        // the search from a group starting up to MaximumTripElements before a changed batch can reach it,
+        // so start from there, aligned to the beginning of the group containing that position
+        auto pos = std::max<qsizetype>(scanEnd, (*changedIt) - MaximumTripElements);
+        if (const auto tgId = groupAt(pos); !tgId.isEmpty()) {
+            while (pos > scanEnd && groupAt(pos - 1) == tgId) {
+                --pos;
+            }
+        }
+
+        QString prevGroup;
+        qsizetype lastChanged = -1;
+        for (; pos < (qsizetype)m_reservations.size(); ++pos) {
+            // further changes within reach of the search from here extend the current window
+            while (changedIt != changed.end() && (*changedIt) <= pos + MaximumTripElements) {
+                lastChanged = std::max(lastChanged, *changedIt);
+                ++changedIt;
+            }
+
+            const auto it = m_reservations.cbegin() + pos;
+            const auto tgId = groupAt(pos);
+            if (!tgId.isEmpty() && tgId == prevGroup) {
+                // in the middle of an existing group
+                continue;
+            }
+
+            // past all changes and at the start of a group that hasn't been touched by this scan:
+            // the search from here doesn't reach any change anymore, so everything following is unaffected
+            if (pos > lastChanged && !tgId.isEmpty()) {
+                const auto elems = tripGroup(tgId).elements();
+                if (!elems.isEmpty() && elems.constFirst() == *it) {
+                    break;
+                }
+            }
+
+            scanOne(it);
+            prevGroup = groupAt(pos);
+        }
+        scanEnd = pos;
+    }
+
+    m_reservations.clear();
+}
+
+void TripGroupManager::scanPending()
+{
+    scanAround(std::exchange(m_pendingScanBatches, {}));
+}
+
 static bool isConnectedTransition(const QVariant &fromRes, const QVariant &toRes)
 {
     const auto from = LocationUtil::arrivalLocation(fromRes);
@@ -961,9 +1062,7 @@ QString TripGroupManager::merge(const QString &tgId1, const QString &tgId2, cons
 
     Q_EMIT tripGroupAboutToBeRemoved(tgId2);
     m_tripGroups.remove(tgId2);
-    if (!QFile::remove(fileForGroup(tgId2))) {
-        qCWarning(Log) << "Failed to delete trip group file!" << tgId2;
-    }
+    FileWriteQueue::remove(fileForGroup(tgId2));
 
     Q_EMIT tripGroupRemoved(tgId2);
     Q_EMIT tripGroupChanged(tgId1);
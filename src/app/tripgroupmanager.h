@@ -104,6 +104,7 @@ private:
     void removeElementsFromGroups(const QStringList &elements, const QString &excludedTgId, bool markAsExplicit);
 
     void batchAdded(const QString &resId);
+    void batchesChanged(const QStringList &batchIds);
     void batchContentChanged(const QString &resId);
     void batchRenamed(const QString &oldBatchId, const QString &newBatchId);
     void batchRemoved(const QString &resId);
@@ -112,6 +113,12 @@ private:
 
     [[nodiscard]] bool hasUngroupedReservations() const;
     void scanAll();
+    /** Re-evaluate the grouping only around the given batches.
+     *  Groups far enough away from any of those can't be affected by their change,
+     *  so this only scans a window of about MaximumTripElements around each of them.
+     */
+    void scanAround(const QStringList &batchIds);
+    void scanPending();
     void scanOne(std::vector<QString>::const_iterator beginIt);
     void createAutomaticGroup(const QStringList &elems);
     void checkConsistency();
@@ -133,6 +140,8 @@ private:
     QHash<QString, QString> m_reservationToGroupMap;
 
     std::vector<QString> m_reservations;
+    // batches changed since the last scan, for incremental scanning
+    QStringList m_pendingScanBatches;
 
     struct ReservationNumberSearch {
         int type;
@@ -84,7 +84,7 @@ void TripGroupMapModel::recompute()
 
         // reservation
         if (LocationUtil::isLocationChange(res)) {
-            const auto jny = m_liveDataMgr->journey(resId);
+            const auto jny = m_liveDataMgr->journeyWithPath(resId);
             if (jny.mode() != JourneySection::Invalid) {
                 expandJourneySection(jny);
             } else {
@@ -5,6 +5,7 @@
 #include "tripgroupmodel.h"
 
 #include "constants.h"
+#include "deadlinescheduler.h"
 #include "logging.h"
 #include "reservationhelper.h"
 #include "reservationmanager.h"
@@ -32,11 +33,6 @@ TripGroupModel::TripGroupModel(QObject *parent)
         Q_EMIT dataChanged(index(0, 0), index(rowCount() - 1, 0));
         scheduleUpdate();
     });
-
-    connect(&m_currentBatchTimer, &QTimer::timeout, this, &TripGroupModel::currentBatchChanged);
-    connect(&m_currentBatchTimer, &QTimer::timeout, this, &TripGroupModel::scheduleCurrentBatchTimer);
-    m_currentBatchTimer.setTimerType(Qt::VeryCoarseTimer);
-    m_currentBatchTimer.setSingleShot(true);
 }
 
 TripGroupModel::~TripGroupModel() = default;
@@ -64,7 +60,7 @@ void TripGroupModel::setTripGroupManager(TripGroupManager *tripGroupManager)
     connect(m_tripGroupManager, &TripGroupManager::tripGroupRemoved, this, &TripGroupModel::tripGroupRemoved);
 
     const auto currentBatchChangeHandler = [this]() {
-        scheduleCurrentBatchTimer();
+        scheduleCurrentBatchUpdate();
         Q_EMIT currentBatchChanged();
     };
     connect(m_tripGroupManager, &TripGroupManager::tripGroupAdded, this, currentBatchChangeHandler);
@@ -76,7 +72,7 @@ void TripGroupModel::setTripGroupManager(TripGroupManager *tripGroupManager)
 
     endResetModel();
     scheduleUpdate();
-    scheduleCurrentBatchTimer();
+    scheduleCurrentBatchUpdate();
 
     Q_EMIT currentBatchChanged();
 }
@@ -466,7 +462,7 @@ void TripGroupModel::scheduleUpdate()
     }
 }
 
-void TripGroupModel::scheduleCurrentBatchTimer()
+void TripGroupModel::scheduleCurrentBatchUpdate()
 {
     // find relevant trip groups
     auto tgIds =
@@ -523,16 +519,15 @@ void TripGroupModel::scheduleCurrentBatchTimer()
     }
 
     if (!triggerTime.isValid()) {
+        DeadlineScheduler::instance()->cancel(this);
         return;
     }
-    // QTimer only has 31bit for its msec interval
-    if (now().secsTo(triggerTime) * 1000 > std::numeric_limits<int>::max()) {
-        qCDebug(Log) << "not scheduling trip group model update, would overflow QTimer" << triggerTime;
-        m_currentBatchTimer.start(std::numeric_limits<int>::max());
-    } else {
-        m_currentBatchTimer.setInterval(std::chrono::seconds(std::max<qint64>(60, now().secsTo(triggerTime))));
-        m_currentBatchTimer.start();
-    }
+    // now() might be overridden in unit tests, deadlines are in actual time
+    const auto delay = std::max<qint64>(60, now().secsTo(triggerTime));
+    DeadlineScheduler::instance()->schedule(this, QDateTime::currentDateTime().addSecs(delay), [this]() {
+        Q_EMIT currentBatchChanged();
+        scheduleCurrentBatchUpdate();
+    });
 }
 
 QVariant TripGroupModel::locationAtTime(const QDateTime &dt) const
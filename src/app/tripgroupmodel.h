@@ -88,11 +88,10 @@ private:
     [[nodiscard]] bool tripGroupLessThan(const QString &lhs, const QDateTime &rhs) const;
 
     void scheduleUpdate();
-    void scheduleCurrentBatchTimer();
+    void scheduleCurrentBatchUpdate();
 
     TripGroupManager *m_tripGroupManager = nullptr;
     std::vector<QString> m_tripGroups;
     QTimer m_updateTimer;
-    QTimer m_currentBatchTimer;
     QDateTime m_unitTestTime;
 };
@@ -0,0 +1,129 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "tripquerydispatcher.h"
+#include "logging.h"
+
+#include <KPublicTransport/JourneySection>
+#include <KPublicTransport/Manager>
+#include <KPublicTransport/TripReply>
+
+#include <algorithm>
+
+using namespace Qt::Literals;
+
+static constexpr const int MAX_CONCURRENT_QUERIES = 2;
+
+TripQueryDispatcher::TripQueryDispatcher(KPublicTransport::Manager *ptMgr, QObject *parent)
+    : QObject(parent)
+    , m_ptMgr(ptMgr)
+    , m_maxConcurrentQueries(MAX_CONCURRENT_QUERIES)
+{
+}
+
+TripQueryDispatcher::~TripQueryDispatcher() = default;
+
+void TripQueryDispatcher::query(const QString &batchId, const KPublicTransport::TripRequest &req)
+{
+    const auto key = queryKey(req);
+    const auto it = std::find_if(m_queries.begin(), m_queries.end(), [&key](const auto &q) {
+        return q.key == key;
+    });
+    if (it != m_queries.end()) {
+        qCDebug(Log) << "coalescing trip query for" << batchId << "with" << (*it).batchIds;
+        if (!(*it).batchIds.contains(batchId)) {
+            (*it).batchIds.push_back(batchId);
+        }
+        return;
+    }
+
+    m_queries.push_back({key, backendKey(req), req, {batchId}});
+    dispatch();
+}
+
+void TripQueryDispatcher::setMaximumConcurrentQueries(int count)
+{
+    m_maxConcurrentQueries = std::max(1, count);
+    dispatch();
+}
+
+qsizetype TripQueryDispatcher::runningQueries() const
+{
+    return std::count_if(m_queries.begin(), m_queries.end(), [](const auto &q) {
+        return q.running;
+    });
+}
+
+qsizetype TripQueryDispatcher::queuedQueries() const
+{
+    return (qsizetype)m_queries.size() - runningQueries();
+}
+
+qsizetype TripQueryDispatcher::runningQueries(const QString &backendKey) const
+{
+    return std::count_if(m_queries.begin(), m_queries.end(), [&backendKey](const auto &q) {
+        return q.running && q.backendKey == backendKey;
+    });
+}
+
+QString TripQueryDispatcher::queryKey(const KPublicTransport::TripRequest &req)
+{
+    // everything that goes into the request, so that we only merge requests that would get the same result
+    const auto jny = req.journeySection();
+    const auto locationKey = [](const KPublicTransport::Location &loc) {
+        return loc.name() + '@'_L1 + QString::number(loc.latitude()) + ','_L1 + QString::number(loc.longitude());
+    };
+    return QString::number(jny.mode()) + '|'_L1 + jny.route().line().name() + '|'_L1 + QString::number(jny.route().line().mode()) + '|'_L1
+        + jny.scheduledDepartureTime().toString(Qt::ISODate) + '|'_L1 + locationKey(jny.from()) + '|'_L1 + locationKey(jny.to()) + '|'_L1
+        + backendKey(req) + '|'_L1 + (req.downloadAssets() ? '1'_L1 : '0'_L1);
+}
+
+QString TripQueryDispatcher::backendKey(const KPublicTransport::TripRequest &req)
+{
+    // queries without explicit backends share the same budget
+    auto backendIds = req.backendIds();
+    backendIds.sort();
+    return backendIds.join(','_L1);
+}
+
+void TripQueryDispatcher::dispatch()
+{
+    // index based, starting a query might modify m_queries
+    for (std::size_t i = 0; i < m_queries.size(); ++i) {
+        if (!m_queries[i].running && runningQueries(m_queries[i].backendKey) < m_maxConcurrentQueries) {
+            start(m_queries[i]);
+        }
+    }
+}
+
+void TripQueryDispatcher::start(Query &query)
+{
+    query.running = true;
+    const auto key = query.key;
+    auto reply = m_ptMgr->queryTrip(query.request);
+    connect(reply, &KPublicTransport::Reply::finished, this, [this, reply, key]() {
+        reply->deleteLater();
+
+        const auto it = std::find_if(m_queries.begin(), m_queries.end(), [&key](const auto &q) {
+            return q.key == key;
+        });
+        if (it == m_queries.end()) {
+            return;
+        }
+        const auto batchIds = std::move((*it).batchIds);
+        m_queries.erase(it);
+
+        for (const auto &batchId : batchIds) {
+            if (reply->error() == KPublicTransport::Reply::NoError) {
+                Q_EMIT tripQueryFinished(batchId, reply->trip());
+            } else {
+                Q_EMIT tripQueryFailed(batchId);
+            }
+        }
+        dispatch();
+    });
+}
+
+#include "moc_tripquerydispatcher.cpp"
@@ -0,0 +1,73 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef TRIPQUERYDISPATCHER_H
+#define TRIPQUERYDISPATCHER_H
+
+#include <KPublicTransport/TripRequest>
+
+#include <QObject>
+#include <QStringList>
+
+#include <vector>
+
+namespace KPublicTransport
+{
+class JourneySection;
+class Manager;
+}
+
+/** Runs trip queries for live data updates.
+ *  Identical queries for several batches (e.g. the same train run booked separately
+ *  for different travelers) are only sent once, and the number of queries running
+ *  in parallel against the same set of backends is limited, further queries are
+ *  queued until a slot becomes available.
+ */
+class TripQueryDispatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TripQueryDispatcher(KPublicTransport::Manager *ptMgr, QObject *parent = nullptr);
+    ~TripQueryDispatcher() override;
+
+    /** Query the trip for @p batchId.
+     *  If an identical query is already queued or running, @p batchId is attached to that one.
+     */
+    void query(const QString &batchId, const KPublicTransport::TripRequest &req);
+
+    /** Maximum number of queries running in parallel for the same backends. */
+    void setMaximumConcurrentQueries(int count);
+
+    [[nodiscard]] qsizetype runningQueries() const;
+    [[nodiscard]] qsizetype queuedQueries() const;
+
+Q_SIGNALS:
+    /** A query for @p batchId finished successfully. */
+    void tripQueryFinished(const QString &batchId, const KPublicTransport::JourneySection &trip);
+    /** A query for @p batchId failed. */
+    void tripQueryFailed(const QString &batchId);
+
+private:
+    struct Query {
+        QString key;
+        QString backendKey;
+        KPublicTransport::TripRequest request;
+        QStringList batchIds;
+        bool running = false;
+    };
+
+    [[nodiscard]] static QString queryKey(const KPublicTransport::TripRequest &req);
+    [[nodiscard]] static QString backendKey(const KPublicTransport::TripRequest &req);
+    [[nodiscard]] qsizetype runningQueries(const QString &backendKey) const;
+    void dispatch();
+    void start(Query &query);
+
+    KPublicTransport::Manager *m_ptMgr = nullptr;
+    // in submission order, queued ones are started first come first serve
+    std::vector<Query> m_queries;
+    int m_maxConcurrentQueries;
+};
+
+#endif // TRIPQUERYDISPATCHER_H
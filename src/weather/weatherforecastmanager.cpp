@@ -22,6 +22,7 @@
 #include <zlib.h>
 
 #include <cmath>
+#include <utility>
 
 WeatherForecastManager* WeatherForecastManager::s_instance = nullptr;
 bool WeatherForecastManager::s_allowNetwork = false;
@@ -69,6 +70,7 @@ void WeatherForecastManager::setAllowNetworkAccess(bool enabled)
 {
     s_allowNetwork = enabled;
     if (s_instance) {
+        Q_EMIT s_instance->forecastTilesUpdated(s_instance->m_monitoredTiles);
         Q_EMIT s_instance->forecastUpdated();
         if (enabled) {
             s_instance->scheduleUpdate();
@@ -219,11 +221,15 @@ void WeatherForecastManager::tileDownloaded()
         qWarning() << m_pendingReply->errorString();
     } else {
         writeToCacheFile(m_pendingReply);
+        m_updatedTiles.push_back(m_pendingReply->request().attribute(QNetworkRequest::User).value<WeatherTile>());
     }
 
     m_pendingReply->deleteLater();
     m_pendingReply = nullptr;
     if (m_pendingTiles.empty()) {
+        if (!m_updatedTiles.empty()) {
+            Q_EMIT forecastTilesUpdated(std::exchange(m_updatedTiles, {}));
+        }
         Q_EMIT forecastUpdated();
     }
     fetchNext();
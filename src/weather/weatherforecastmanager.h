@@ -57,6 +57,8 @@ public:
 Q_SIGNALS:
     /** Updated when new forecast data has been retrieved. */
     void forecastUpdated();
+    /** Emitted right before forecastUpdated(), with the tiles for which forecast data changed. */
+    void forecastTilesUpdated(const std::vector<WeatherTile> &tiles);
 
 private:
     friend class WeatherTest;
@@ -78,6 +80,7 @@ private:
 
     std::vector<WeatherTile> m_monitoredTiles;
     std::deque<WeatherTile> m_pendingTiles;
+    std::vector<WeatherTile> m_updatedTiles;
     mutable std::unordered_map<WeatherTile, std::vector<WeatherForecast>> m_forecastData;
 
     QNetworkAccessManager *m_nam = nullptr;
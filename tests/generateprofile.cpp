@@ -0,0 +1,65 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "profilegenerator.h"
+#include "reservationmanager.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QStandardPaths>
+
+using namespace Qt::Literals;
+
+int main(int argc, char **argv)
+{
+    // same as the application, so we write into its data locations
+    // use XDG_DATA_HOME/XDG_CONFIG_HOME to direct this to a separate profile
+    QCoreApplication::setApplicationName(u"itinerary"_s);
+    QCoreApplication::setOrganizationName(u"KDE"_s);
+    QCoreApplication::setOrganizationDomain(u"kde.org"_s);
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(u"Generates a synthetic KDE Itinerary profile for benchmarking and stress testing."_s);
+    parser.addHelpOption();
+    QCommandLineOption countOpt(u"count"_s, u"Number of reservations to generate."_s, u"count"_s, u"10000"_s);
+    parser.addOption(countOpt);
+    QCommandLineOption seedOpt(u"seed"_s, u"Seed for the random number generator."_s, u"seed"_s, u"42"_s);
+    parser.addOption(seedOpt);
+    QCommandLineOption liveDataOpt(u"live-data-ratio"_s, u"Fraction of transport reservations with live data."_s, u"ratio"_s, u"0.25"_s);
+    parser.addOption(liveDataOpt);
+    QCommandLineOption documentOpt(u"document-ratio"_s, u"Fraction of reservations with an attached document."_s, u"ratio"_s, u"0.1"_s);
+    parser.addOption(documentOpt);
+    QCommandLineOption noTransfersOpt(u"no-transfers"_s, u"Do not generate transfers."_s);
+    parser.addOption(noTransfersOpt);
+    QCommandLineOption forceOpt(u"force"_s, u"Add to an existing non-empty profile."_s);
+    parser.addOption(forceOpt);
+    parser.process(app);
+
+    if (!parser.isSet(forceOpt)) {
+        ReservationManager resMgr;
+        if (!resMgr.batches().empty()) {
+            qWarning() << "Profile in" << QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                       << "is not empty, refusing to modify it without --force.";
+            return 1;
+        }
+    }
+
+    ProfileGenerator::Options options;
+    options.reservationCount = parser.value(countOpt).toInt();
+    options.seed = parser.value(seedOpt).toUInt();
+    options.liveDataRatio = parser.value(liveDataOpt).toDouble();
+    options.documentRatio = parser.value(documentOpt).toDouble();
+    options.transfers = !parser.isSet(noTransfersOpt);
+
+    QElapsedTimer timer;
+    timer.start();
+    ProfileGenerator::generate(options);
+    qInfo() << "Generated" << options.reservationCount << "reservations in" << QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) << "in"
+            << timer.elapsed() << "ms";
+    return 0;
+}
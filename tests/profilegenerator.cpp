@@ -0,0 +1,401 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "profilegenerator.h"
+
+#include "documentmanager.h"
+#include "filewritequeue.h"
+#include "livedata.h"
+#include "reservationmanager.h"
+#include "transfer.h"
+#include "transfermanager.h"
+#include "tripgroup.h"
+#include "tripgroupmanager.h"
+
+#include <KItinerary/DocumentUtil>
+#include <KItinerary/JsonLdDocument>
+#include <KItinerary/LocationUtil>
+#include <KItinerary/SortUtil>
+
+#include <KPublicTransport/Journey>
+#include <KPublicTransport/Location>
+#include <KPublicTransport/Stopover>
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTimeZone>
+
+#include <iterator>
+
+using namespace Qt::Literals;
+using namespace KItinerary;
+
+namespace
+{
+struct City {
+    const char *name;
+    const char *country;
+    const char *iataCode;
+    const char *timeZone;
+    double latitude;
+    double longitude;
+};
+}
+
+static constexpr const City cities[] = {
+    {"Berlin", "DE", "BER", "Europe/Berlin", 52.525, 13.369},
+    {"Brussels", "BE", "BRU", "Europe/Brussels", 50.836, 4.336},
+    {"Amsterdam", "NL", "AMS", "Europe/Amsterdam", 52.379, 4.900},
+    {"Paris", "FR", "CDG", "Europe/Paris", 48.880, 2.355},
+    {"Vienna", "AT", "VIE", "Europe/Vienna", 48.185, 16.376},
+    {"Zurich", "CH", "ZRH", "Europe/Zurich", 47.378, 8.540},
+    {"Milan", "IT", "MXP", "Europe/Rome", 45.486, 9.204},
+    {"Prague", "CZ", "PRG", "Europe/Prague", 50.083, 14.435},
+    {"Copenhagen", "DK", "CPH", "Europe/Copenhagen", 55.673, 12.565},
+    {"London", "GB", "LHR", "Europe/London", 51.532, -0.127},
+    {"Madrid", "ES", "MAD", "Europe/Madrid", 40.406, -3.689},
+    {"Lisbon", "PT", "LIS", "Europe/Lisbon", 38.714, -9.122},
+    {"Helsinki", "FI", "HEL", "Europe/Helsinki", 60.171, 24.941},
+    {"Warsaw", "PL", "WAW", "Europe/Warsaw", 52.229, 21.003},
+    {"Athens", "GR", "ATH", "Europe/Athens", 37.992, 23.721},
+    {"New York", "US", "JFK", "America/New_York", 40.750, -73.993},
+    {"Montreal", "CA", "YUL", "America/Toronto", 45.500, -73.566},
+    {"Tokyo", "JP", "HND", "Asia/Tokyo", 35.681, 139.767},
+};
+static constexpr const auto cityCount = (int)std::size(cities);
+
+// average number of reservations per trip, for spreading the trips around the current date
+constexpr auto ReservationsPerTrip = 8;
+constexpr auto DaysPerTrip = 14;
+
+[[nodiscard]] static QDateTime localTime(const City &city, const QDate &date, const QTime &time)
+{
+    return QDateTime(date, time, QTimeZone(city.timeZone));
+}
+
+[[nodiscard]] static QJsonObject geo(const City &city)
+{
+    return QJsonObject{
+        {"@type"_L1, "GeoCoordinates"_L1},
+        {"latitude"_L1, city.latitude},
+        {"longitude"_L1, city.longitude},
+    };
+}
+
+[[nodiscard]] static QJsonObject address(const City &city)
+{
+    return QJsonObject{
+        {"@type"_L1, "PostalAddress"_L1},
+        {"addressLocality"_L1, QString::fromUtf8(city.name)},
+        {"addressCountry"_L1, QString::fromUtf8(city.country)},
+    };
+}
+
+[[nodiscard]] static QJsonObject trainStation(const City &city)
+{
+    return QJsonObject{
+        {"@type"_L1, "TrainStation"_L1},
+        {"name"_L1, QString::fromUtf8(city.name) + " Central"_L1},
+        {"geo"_L1, geo(city)},
+        {"address"_L1, address(city)},
+    };
+}
+
+[[nodiscard]] static QJsonObject airport(const City &city)
+{
+    return QJsonObject{
+        {"@type"_L1, "Airport"_L1},
+        {"name"_L1, QString::fromUtf8(city.name) + " Airport"_L1},
+        {"iataCode"_L1, QString::fromUtf8(city.iataCode)},
+        {"geo"_L1, geo(city)},
+        {"address"_L1, address(city)},
+    };
+}
+
+[[nodiscard]] static QJsonObject person(int traveler)
+{
+    static constexpr const char *names[] = {"Dr. Konqi", "Katie", "Kiki", "Konqui Jr."};
+    return QJsonObject{
+        {"@type"_L1, "Person"_L1},
+        {"name"_L1, QString::fromUtf8(names[traveler % std::size(names)])},
+    };
+}
+
+namespace
+{
+class Generator
+{
+public:
+    explicit Generator(const ProfileGenerator::Options &options)
+        : m_options(options)
+        , m_rng(options.seed)
+    {
+    }
+
+    void generate();
+    QJsonArray reservations;
+
+private:
+    void addTrip(const QDate &date);
+    /** Adds a transport leg, returns the arrival time. */
+    QDateTime addLeg(const City &from, const City &to, const QDateTime &departure);
+    void addHotel(const City &city, const QDate &checkin, int nights);
+    void addEvent(const City &city, const QDate &date);
+
+    ProfileGenerator::Options m_options;
+    QRandomGenerator m_rng;
+    int m_home = 0;
+    int m_travelers = 1;
+    int m_tripNumber = 0;
+};
+}
+
+void Generator::generate()
+{
+    m_home = (int)m_rng.bounded(cityCount);
+    const auto tripCount = std::max(1, m_options.reservationCount / ReservationsPerTrip);
+    auto date = QDate::currentDate().addDays(-(qint64)tripCount * DaysPerTrip / 2);
+    while (reservations.size() < m_options.reservationCount) {
+        addTrip(date);
+        date = date.addDays(DaysPerTrip / 2 + m_rng.bounded(DaysPerTrip));
+    }
+}
+
+void Generator::addTrip(const QDate &date)
+{
+    ++m_tripNumber;
+    // mostly traveling alone, sometimes in small groups
+    m_travelers = m_rng.bounded(10) < 6 ? 1 : 2 + (int)m_rng.bounded(3);
+
+    const auto stops = 1 + (int)m_rng.bounded(3);
+    const auto *prev = &cities[m_home];
+    auto departure = localTime(*prev, date, QTime(7 + (int)m_rng.bounded(6), 5 * (int)m_rng.bounded(12)));
+    for (int i = 0; i < stops; ++i) {
+        auto next = (int)m_rng.bounded(cityCount - 1);
+        next = next >= m_home ? next + 1 : next;
+        if (&cities[next] == prev) {
+            continue;
+        }
+        const auto arrival = addLeg(*prev, cities[next], departure);
+        const auto nights = 1 + (int)m_rng.bounded(4);
+        addHotel(cities[next], arrival.date(), nights);
+        if (m_rng.bounded(5) == 0) {
+            addEvent(cities[next], arrival.date());
+        }
+        prev = &cities[next];
+        departure = localTime(*prev, arrival.date().addDays(nights), QTime(10 + (int)m_rng.bounded(6), 5 * (int)m_rng.bounded(12)));
+    }
+    addLeg(*prev, cities[m_home], departure);
+}
+
+QDateTime Generator::addLeg(const City &from, const City &to, const QDateTime &departure)
+{
+    const auto distance = LocationUtil::distance(from.latitude, from.longitude, to.latitude, to.longitude);
+    const bool isFlight = distance > 1'200'000.0 || m_rng.bounded(2) == 0;
+    // very rough average speeds, good enough for plausible timelines
+    const auto duration = isFlight ? 3600 + (qint64)(distance / 220.0) : 600 + (qint64)(distance / 30.0);
+    const auto arrival = departure.addSecs(duration).toTimeZone(QTimeZone(to.timeZone));
+    const auto reservationNumber = u"%1%2"_s.arg(isFlight ? "FL"_L1 : "TR"_L1).arg(m_tripNumber * 100 + reservations.size() % 100, 8, 10, QLatin1Char('0'));
+
+    QJsonObject trip;
+    if (isFlight) {
+        trip = QJsonObject{
+            {"@type"_L1, "Flight"_L1},
+            {"flightNumber"_L1, QString::number(100 + m_rng.bounded(9000))},
+            {"airline"_L1, QJsonObject{{"@type"_L1, "Airline"_L1}, {"iataCode"_L1, "KD"_L1}, {"name"_L1, "KDE Airlines"_L1}}},
+            {"departureAirport"_L1, airport(from)},
+            {"departureTime"_L1, departure.toString(Qt::ISODate)},
+            {"arrivalAirport"_L1, airport(to)},
+            {"arrivalTime"_L1, arrival.toString(Qt::ISODate)},
+        };
+    } else {
+        trip = QJsonObject{
+            {"@type"_L1, "TrainTrip"_L1},
+            {"trainNumber"_L1, u"ICE %1"_s.arg(100 + m_rng.bounded(900))},
+            {"departureStation"_L1, trainStation(from)},
+            {"departurePlatform"_L1, QString::number(1 + m_rng.bounded(20))},
+            {"departureTime"_L1, departure.toString(Qt::ISODate)},
+            {"arrivalStation"_L1, trainStation(to)},
+            {"arrivalTime"_L1, arrival.toString(Qt::ISODate)},
+        };
+    }
+
+    const auto row = 1 + m_rng.bounded(30);
+    for (int i = 0; i < m_travelers; ++i) {
+        QJsonObject res{
+            {"@type"_L1, isFlight ? "FlightReservation"_L1 : "TrainReservation"_L1},
+            {"reservationNumber"_L1, reservationNumber},
+            {"reservationFor"_L1, trip},
+            {"underName"_L1, person(i)},
+        };
+        if (isFlight) {
+            res.insert("airplaneSeat"_L1, QString::number(row) + QLatin1Char(char('A' + i)));
+        } else {
+            res.insert("reservedTicket"_L1,
+                       QJsonObject{
+                           {"@type"_L1, "Ticket"_L1},
+                           {"ticketedSeat"_L1,
+                            QJsonObject{{"@type"_L1, "Seat"_L1}, {"seatNumber"_L1, QString::number(row * 10 + i)}, {"seatSection"_L1, QString::number(1 + row % 12)}}},
+                           {"ticketToken"_L1, u"qrCode:%1-%2"_s.arg(reservationNumber).arg(i)},
+                       });
+        }
+        reservations.push_back(res);
+    }
+    return arrival;
+}
+
+void Generator::addHotel(const City &city, const QDate &checkin, int nights)
+{
+    reservations.push_back(QJsonObject{
+        {"@type"_L1, "LodgingReservation"_L1},
+        {"reservationNumber"_L1, u"H%1"_s.arg(m_tripNumber * 10 + reservations.size() % 10)},
+        {"reservationFor"_L1,
+         QJsonObject{
+             {"@type"_L1, "LodgingBusiness"_L1},
+             {"name"_L1, u"Hotel %1 %2"_s.arg(QString::fromUtf8(city.name)).arg(1 + m_rng.bounded(20))},
+             {"address"_L1, address(city)},
+             {"geo"_L1, geo(city)},
+         }},
+        {"checkinTime"_L1, localTime(city, checkin, QTime(15, 0)).toString(Qt::ISODate)},
+        {"checkoutTime"_L1, localTime(city, checkin.addDays(nights), QTime(11, 0)).toString(Qt::ISODate)},
+        {"underName"_L1, person(0)},
+    });
+}
+
+void Generator::addEvent(const City &city, const QDate &date)
+{
+    const auto start = localTime(city, date, QTime(19, 30));
+    const QJsonObject event{
+        {"@type"_L1, "Event"_L1},
+        {"name"_L1, u"Concert in %1"_s.arg(QString::fromUtf8(city.name))},
+        {"startDate"_L1, start.toString(Qt::ISODate)},
+        {"endDate"_L1, start.addSecs(3 * 3600).toString(Qt::ISODate)},
+        {"location"_L1, QJsonObject{{"@type"_L1, "Place"_L1}, {"name"_L1, "Concert Hall"_L1}, {"geo"_L1, geo(city)}, {"address"_L1, address(city)}}},
+    };
+    for (int i = 0; i < m_travelers; ++i) {
+        reservations.push_back(QJsonObject{
+            {"@type"_L1, "EventReservation"_L1},
+            {"reservationNumber"_L1, u"EV%1"_s.arg(m_tripNumber)},
+            {"reservationFor"_L1, event},
+            {"underName"_L1, person(i)},
+        });
+    }
+}
+
+QList<QVariant> ProfileGenerator::reservations(const Options &options)
+{
+    Generator generator(options);
+    generator.generate();
+    return JsonLdDocument::fromJson(generator.reservations);
+}
+
+[[nodiscard]] static KPublicTransport::Stopover stopover(const QVariant &place, const QDateTime &dt, qint64 delay)
+{
+    KPublicTransport::Location loc;
+    loc.setName(LocationUtil::name(place));
+    const auto geo = LocationUtil::geo(place);
+    loc.setCoordinate(geo.latitude(), geo.longitude());
+
+    KPublicTransport::Stopover stop;
+    stop.setStopPoint(loc);
+    stop.setScheduledDepartureTime(dt);
+    stop.setExpectedDepartureTime(dt.addSecs(delay));
+    stop.setScheduledArrivalTime(dt);
+    stop.setExpectedArrivalTime(dt.addSecs(delay));
+    return stop;
+}
+
+[[nodiscard]] static LiveData liveData(const QVariant &res, QRandomGenerator &rng)
+{
+    const auto delay = 60 * (qint64)rng.bounded(20);
+
+    KPublicTransport::JourneySection section;
+    section.setMode(KPublicTransport::JourneySection::PublicTransport);
+    section.setDeparture(stopover(LocationUtil::departureLocation(res), SortUtil::startDateTime(res), delay));
+    section.setArrival(stopover(LocationUtil::arrivalLocation(res), SortUtil::endDateTime(res), delay));
+
+    LiveData ld;
+    ld.trip = section;
+    ld.departureIndex = 0;
+    ld.arrivalIndex = 1;
+    ld.journeyTimestamp = SortUtil::startDateTime(res).addSecs(-600);
+    return ld;
+}
+
+[[nodiscard]] static QByteArray documentData(int index)
+{
+    // not a valid PDF, but roughly the size of a typical ticket
+    QByteArray data = "%PDF-1.4\n"_ba;
+    data.append(QByteArray(48 * 1024, char('a' + index % 26)));
+    return data;
+}
+
+void ProfileGenerator::generate(const Options &options)
+{
+    QRandomGenerator rng(options.seed + 1);
+
+    ReservationManager resMgr;
+    TransferManager transferMgr;
+    transferMgr.setReservationManager(&resMgr);
+    TripGroupManager tgMgr;
+    tgMgr.setReservationManager(&resMgr);
+    tgMgr.setTransferManager(&transferMgr);
+    DocumentManager docMgr;
+
+    {
+        TripGroupingBlocker groupingBlocker(&tgMgr);
+        resMgr.addReservations(reservations(options));
+    }
+
+    // transfers to and from home for each trip
+    if (options.transfers) {
+        for (const auto &tgId : tgMgr.tripGroups()) {
+            const auto elements = tgMgr.tripGroup(tgId).elements();
+            if (elements.isEmpty()) {
+                continue;
+            }
+            Transfer transfer;
+            transfer.setState(Transfer::Pending);
+            transfer.setFloatingLocationType(Transfer::FavoriteLocation);
+            transfer.setAnchorTimeDelta(3600);
+            transfer.setReservationId(elements.constFirst());
+            transfer.setAlignment(Transfer::Before);
+            transferMgr.importTransfer(transfer);
+            transfer.setReservationId(elements.constLast());
+            transfer.setAlignment(Transfer::After);
+            transferMgr.importTransfer(transfer);
+        }
+    }
+
+    // live data and documents for some batches
+    {
+        const ReservationBulkUpdate bulkUpdate(&resMgr);
+        const auto batches = resMgr.batches();
+        for (std::size_t i = 0; i < batches.size(); ++i) {
+            const auto &batchId = batches[i];
+            const auto res = resMgr.reservation(batchId);
+            if (LocationUtil::isLocationChange(res) && rng.generateDouble() < options.liveDataRatio) {
+                liveData(res, rng).store(batchId);
+            }
+            if (rng.generateDouble() < options.documentRatio) {
+                const auto docId = u"profilegenerator-%1"_s.arg(i);
+                const auto docInfo = JsonLdDocument::fromJsonSingular(QJsonObject{
+                    {"@type"_L1, "DigitalDocument"_L1},
+                    {"name"_L1, u"ticket-%1.pdf"_s.arg(i)},
+                    {"encodingFormat"_L1, "application/pdf"_L1},
+                });
+                docMgr.addDocument(docId, docInfo, documentData((int)i));
+                for (const auto &resId : resMgr.reservationsForBatch(batchId)) {
+                    auto r = resMgr.reservation(resId);
+                    DocumentUtil::addDocumentId(r, docId);
+                    resMgr.updateReservation(resId, r);
+                }
+            }
+        }
+    }
+
+    FileWriteQueue::flush();
+}
@@ -0,0 +1,44 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef PROFILEGENERATOR_H
+#define PROFILEGENERATOR_H
+
+#include <QList>
+#include <QVariant>
+
+/** Generates synthetic user profiles for benchmarking and stress testing.
+ *  Profiles consist of trips of flights, trains, hotel stays and events with
+ *  one or more travelers, spread around the current date, plus transfers,
+ *  live data and documents for some of those.
+ *
+ *  Results are deterministic for a given seed, apart from being relative to the current date.
+ */
+namespace ProfileGenerator
+{
+struct Options {
+    /** Approximate number of reservations to generate. */
+    int reservationCount = 1000;
+    quint32 seed = 42;
+
+    /** Fraction of transport batches that get live data. */
+    double liveDataRatio = 0.25;
+    /** Fraction of batches that get a document attached. */
+    double documentRatio = 0.1;
+    bool transfers = true;
+};
+
+/** Generates reservations only, without storing anything. */
+[[nodiscard]] QList<QVariant> reservations(const Options &options);
+
+/** Generates a full profile and stores it in the application data location.
+ *  This uses the same code and storage layout as the application, so the application
+ *  name and data locations have to be set up as for the application beforehand.
+ *  Pending writes are flushed before this returns.
+ */
+void generate(const Options &options);
+}
+
+#endif // PROFILEGENERATOR_H
@@ -0,0 +1,150 @@
+/*
+    SPDX-FileCopyrightText: 2026 Volker Krause <vkrause@kde.org>
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "profilegenerator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <span>
+#include <vector>
+
+using namespace Qt::Literals;
+
+struct Phase {
+    qint64 duration = 0; // µs
+    qint64 heapDelta = 0;
+};
+struct StartupRun {
+    qint64 total = 0; // µs
+    std::map<QString, Phase> phases;
+};
+
+[[nodiscard]] static bool runApp(const QString &appPath, const QString &traceFile, StartupRun &run)
+{
+    QFile::remove(traceFile);
+
+    auto env = QProcessEnvironment::systemEnvironment();
+    env.insert(u"ITINERARY_STARTUP_TRACE"_s, traceFile);
+    QProcess proc;
+    proc.setProcessEnvironment(env);
+    proc.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    proc.start(appPath, {u"--self-test"_s});
+    if (!proc.waitForFinished(300'000) || proc.exitStatus() != QProcess::NormalExit) {
+        qWarning() << "Application failed to run:" << appPath << proc.errorString();
+        return false;
+    }
+
+    QFile f(traceFile);
+    if (!f.open(QFile::ReadOnly)) {
+        qWarning() << "Application did not produce a startup trace:" << f.errorString();
+        return false;
+    }
+    const auto events = QJsonDocument::fromJson(f.readAll()).object().value("traceEvents"_L1).toArray();
+    qint64 begin = std::numeric_limits<qint64>::max();
+    qint64 end = 0;
+    for (const auto &v : events) {
+        const auto ev = v.toObject();
+        const auto ts = ev.value("ts"_L1).toInteger();
+        const auto dur = ev.value("dur"_L1).toInteger();
+        begin = std::min(begin, ts);
+        end = std::max(end, ts + dur);
+        auto &phase = run.phases[ev.value("name"_L1).toString()];
+        phase.duration += dur;
+        phase.heapDelta += ev.value("args"_L1).toObject().value("heapDelta"_L1).toInteger();
+    }
+    run.total = std::max<qint64>(0, end - begin);
+    return !events.isEmpty();
+}
+
+static void printResults(const std::vector<StartupRun> &runs)
+{
+    const auto &cold = runs.front();
+    const auto warmRuns = std::span(runs).subspan(1);
+
+    const auto warmMedian = [&warmRuns](auto value) -> qint64 {
+        if (warmRuns.empty()) {
+            return 0;
+        }
+        std::vector<qint64> values;
+        values.reserve(warmRuns.size());
+        std::transform(warmRuns.begin(), warmRuns.end(), std::back_inserter(values), value);
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    };
+
+    printf("%-40s %12s %12s %12s\n", "phase", "cold [ms]", "warm [ms]", "heap [kB]");
+    for (const auto &[name, phase] : cold.phases) {
+        const auto warm = warmMedian([&name](const StartupRun &run) {
+            const auto it = run.phases.find(name);
+            return it == run.phases.end() ? 0 : (*it).second.duration;
+        });
+        printf("%-40s %12.1f %12.1f %12lld\n", qPrintable(name), phase.duration / 1000.0, warm / 1000.0, phase.heapDelta / 1024);
+    }
+    const auto warmTotal = warmMedian([](const StartupRun &run) {
+        return run.total;
+    });
+    printf("%-40s %12.1f %12.1f\n", "total", cold.total / 1000.0, warmTotal / 1000.0);
+}
+
+int main(int argc, char **argv)
+{
+    // must happen before the QStandardPaths is used, and is inherited by the application we launch
+    QTemporaryDir profileDir;
+    qputenv("XDG_DATA_HOME", QFile::encodeName(profileDir.filePath(u"data"_s)));
+    qputenv("XDG_CONFIG_HOME", QFile::encodeName(profileDir.filePath(u"config"_s)));
+    qputenv("XDG_CACHE_HOME", QFile::encodeName(profileDir.filePath(u"cache"_s)));
+
+    QCoreApplication::setApplicationName(u"itinerary"_s);
+    QCoreApplication::setOrganizationName(u"KDE"_s);
+    QCoreApplication::setOrganizationDomain(u"kde.org"_s);
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption countOpt(u"count"_s, u"Number of reservations to generate."_s, u"count"_s, u"1000"_s);
+    parser.addOption(countOpt);
+    QCommandLineOption runsOpt(u"runs"_s, u"Number of warm starts to measure."_s, u"runs"_s, u"5"_s);
+    parser.addOption(runsOpt);
+    parser.addPositionalArgument(u"app"_s, u"Path to the itinerary application executable."_s);
+    parser.process(app);
+    if (parser.positionalArguments().size() != 1 || !profileDir.isValid()) {
+        parser.showHelp(1);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    ProfileGenerator::Options options;
+    options.reservationCount = parser.value(countOpt).toInt();
+    ProfileGenerator::generate(options);
+    qInfo() << "Profile generation took" << timer.elapsed() << "ms";
+
+    // the first run after generating the profile is the cold start, it also includes
+    // one-time work such as data migration, the following ones are warm starts
+    const auto appPath = parser.positionalArguments().at(0);
+    const auto traceFile = profileDir.filePath(u"startup-trace.json"_s);
+    std::vector<StartupRun> runs(1 + std::max(0, parser.value(runsOpt).toInt()));
+    for (auto &run : runs) {
+        if (!runApp(appPath, traceFile, run)) {
+            return 1;
+        }
+    }
+
+    printResults(runs);
+    return 0;
+}